@@ -1,536 +1,2289 @@
-#include <stdio.h>
+#include "C_biblioteca.h"
+
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include <stdbool.h>
-#include <windows.h>
-#include <conio.h>
 #include <wchar.h> 
 
-#ifndef _getwch
-    wint_t _getwch(void);
+#ifndef _WIN32
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <signal.h>
+#include <sys/ioctl.h>
 #endif
 
-#define COLOR_STR_SIZE 20 
-#define C_RESET "\033[0m"
-#define C_BOLD  "\033[1m"
+// ---------------------------------------------------------------------------
+// Camada de plataforma: console do Windows ou terminal POSIX
+// ---------------------------------------------------------------------------
 
-// Códigos de tecla
-#define KEY_ENTER 13
-#define KEY_BACKSPACE 8
-#define KEY_ESC 27
-#define KEY_UP 72
-#define KEY_DOWN 80
-#define KEY_LEFT 75
-#define KEY_RIGHT 77
+// Pausa a thread atual por 'ms' milissegundos
+void tui_sleep_ms(unsigned ms) {
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {}
+#endif
+}
 
-typedef struct {
-    char* buffer;       // Buffer principal de saída
-    size_t capacity;    // Capacidade total alocada
-    size_t size;        // Bytes usados atualmente
-    HANDLE hStdout;     // Handle do console do Windows
-} Renderer;
+// Relógio monotônico em microssegundos
+uint64_t tui_now_us(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER c;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&c);
+    return (uint64_t)(c.QuadPart / freq.QuadPart) * 1000000u
+         + (uint64_t)(c.QuadPart % freq.QuadPart) * 1000000u / (uint64_t)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+#endif
+}
 
-// Inicializa o renderizador e configura UTF-8
-Renderer* renderer_create() {
-    Renderer* r = (Renderer*)malloc(sizeof(Renderer));
-    if (!r) return NULL;
+#ifdef _WIN32
+static DWORD tui_console_modo_orig;
+static bool tui_console_alterado = false;
+#else
+static struct termios tui_termios_orig;
+static volatile sig_atomic_t tui_raw_ativo = 0;
 
-    // Define codificação do console para suportar caracteres especiais
-    SetConsoleOutputCP(CP_UTF8);
-    SetConsoleCP(CP_UTF8);
+// Restaura o modo original do terminal (na saída do processo ou por tui_restore)
+static void tui_raw_restaura(void) {
+    if (tui_raw_ativo) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &tui_termios_orig);
+        tui_raw_ativo = 0;
+    }
+}
 
-    r->capacity = 65536; // Começa com 64KB
-    r->buffer = (char*)malloc(r->capacity);
-    r->size = 0;
-    r->hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
+// Sinal de término: restaura o terminal e repete o sinal com a ação padrão
+static void tui_raw_sinal(int sig) {
+    tui_raw_restaura();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
 
-    if (!r->buffer) {
-        fprintf(stderr, "Erro: Falha na alocacao do buffer.\n");
-        free(r);
-        return NULL;
+// Restaura o terminal nos sinais de término que ainda estão com a ação padrão
+static void tui_raw_instala(void) {
+    static bool instalado = false;
+    if (instalado) return;
+    atexit(tui_raw_restaura);
+    const int sinais[] = { SIGINT, SIGTERM, SIGHUP, SIGQUIT };
+    for (size_t i = 0; i < sizeof(sinais) / sizeof(sinais[0]); i++) {
+        struct sigaction atual;
+        if (sigaction(sinais[i], NULL, &atual) != 0 || atual.sa_handler != SIG_DFL) continue;
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = tui_raw_sinal;
+        sigemptyset(&sa.sa_mask);
+        sigaction(sinais[i], &sa, NULL);
     }
-
-    return r;
+    instalado = true;
 }
 
-// Libera toda a memória alocada
-void renderer_destroy(Renderer* r) {
-    if (r) {
-        if (r->buffer) {
-            free(r->buffer);
-        }
-        free(r);
+// Coloca a entrada padrão em modo bruto (sem eco, sem buffer de linha) na primeira leitura
+static void tui_raw_ativa(void) {
+    if (tui_raw_ativo || !isatty(STDIN_FILENO)) return;
+    if (tcgetattr(STDIN_FILENO, &tui_termios_orig) != 0) return;
+
+    struct termios raw = tui_termios_orig;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_iflag &= ~(ICRNL | IXON);  // Enter chega como 13, como no conio
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0) {
+        tui_raw_ativo = 1;
+        tui_raw_instala();
     }
 }
 
-// Adiciona dados brutos ao buffer, redimensionando se necessário
-void renderer_add_raw(Renderer* r, const char* dados, size_t tamanho) {
-    // Expande capacidade (dobra) se o espaço for insuficiente
-    if (r->size + tamanho >= r->capacity) {
-        while (r->size + tamanho >= r->capacity) {
-            r->capacity *= 2;
-        }
-        
-        char* temp = (char*)realloc(r->buffer, r->capacity);
-        if (!temp) {
-            fprintf(stderr, "Erro fatal: Falha ao expandir buffer.\n");
-            exit(1);
-        }
-        r->buffer = temp;
+// Espera até 'ms' milissegundos por dados no descritor
+static bool tui_fd_pronto(int fd, int ms) {
+    struct pollfd p = { fd, POLLIN, 0 };
+    return poll(&p, 1, ms) > 0;
+}
+#endif
+
+// Codifica um ponto de código em UTF-8 (retorna bytes escritos, 0 se inválido)
+int tui_utf8_encode(unsigned long cp, char* out) {
+    if (cp < 0x80) { out[0] = (char)cp; return 1; }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp >= 0xD800 && cp <= 0xDFFF) return 0; // Metade de par substituto
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    if (cp < 0x110000) {
+        out[0] = (char)(0xF0 | (cp >> 18));
+        out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = (char)(0x80 | (cp & 0x3F));
+        return 4;
     }
+    return 0;
+}
 
-    // Copia dados para a próxima posição livre
-    memcpy(r->buffer + r->size, dados, tamanho);
-    r->size += tamanho;
+// Saída padrão do processo
+static tui_fd tui_stdout(void) {
+#ifdef _WIN32
+    return GetStdHandle(STD_OUTPUT_HANDLE);
+#else
+    return STDOUT_FILENO;
+#endif
 }
 
-// Wrapper para adicionar strings terminadas em nulo
-void renderer_add(Renderer* r, const char* content) {
-    if (content == NULL) return;
-    renderer_add_raw(r, content, strlen(content));
+// Entrada padrão do processo
+static tui_fd tui_stdin(void) {
+#ifdef _WIN32
+    return GetStdHandle(STD_INPUT_HANDLE);
+#else
+    return STDIN_FILENO;
+#endif
 }
 
-// Posiciona o cursor usando sequências ANSI
-void renderer_move_cursor(Renderer* r, int y, int x) {
-    char buffer[32];
-    int len = sprintf(buffer, "\033[%d;%dH", y, x);
-    renderer_add_raw(r, buffer, len);
+// Devolve o console do processo ao modo original (sem efeito se não foi alterado).
+// Feito também na saída normal e, no POSIX, em SIGINT/SIGTERM/SIGHUP/SIGQUIT; a
+// próxima leitura volta ao modo bruto.
+void tui_restore(void) {
+#ifdef _WIN32
+    if (tui_console_alterado) {
+        SetConsoleMode(tui_stdin(), tui_console_modo_orig);
+        tui_console_alterado = false;
+    }
+#else
+    tui_raw_restaura();
+#endif
 }
 
-// Despeja o conteúdo do buffer no console e reseta o índice
-void renderer_render(Renderer* r) {
-    if (r->size == 0) return;
-    DWORD escritos = 0;
-    WriteConsoleA(r->hStdout, r->buffer, (DWORD)r->size, &escritos, NULL);    
-    r->size = 0;
+// Consulta o tamanho do terminal ligado a 'fd' (linhas x colunas)
+bool tui_terminal_size(tui_fd fd, int* rows, int* cols) {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(fd, &info)) return false;
+    *rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+    *cols = info.srWindow.Right - info.srWindow.Left + 1;
+    return true;
+#else
+    struct winsize ws;
+    if (ioctl(fd, TIOCGWINSZ, &ws) != 0 || ws.ws_row == 0) return false;
+    *rows = ws.ws_row;
+    *cols = ws.ws_col;
+    return true;
+#endif
 }
 
-typedef struct {
-    const char* B_RESET;
-    const char* B_SPACE;
-} Interface;
+#ifndef _WIN32
+static volatile sig_atomic_t tui_winch_count = 0; // Incrementado a cada SIGWINCH
 
-// Inicializa a estrutura de interface e constantes
-Interface* interface_create() {
-    Interface* i = (Interface*)malloc(sizeof(Interface));
-    i->B_RESET = "\033[0m";
-    i->B_SPACE = " ";
-    return i;
+static void tui_winch_handler(int sig) {
+    (void)sig;
+    tui_winch_count++;
 }
 
-// Libera a memória da interface
-void interface_destroy(Interface* i) {
-    if (i) free(i);
+// Instala o tratador de SIGWINCH (sem SA_RESTART, para interromper a espera por entrada)
+static void tui_winch_install(void) {
+    static bool instalado = false;
+    if (instalado) return;
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = tui_winch_handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGWINCH, &sa, NULL);
+    instalado = true;
 }
+#endif
 
-// Calcula o comprimento visual da string (ignora ANSI e formatação UTF-8)
-int interface_visible_len(const char* s) {
-    if (!s) return 0;
-    int length = 0;
-    bool in_escape = false;
-    size_t n = strlen(s);
+// ---------------------------------------------------------------------------
+// Capacidades do terminal: detectadas na primeira consulta (ambiente e terminfo)
+// e guardadas para o resto do processo
+// ---------------------------------------------------------------------------
 
-    for (size_t i = 0; i < n; i++) {
-        unsigned char c = (unsigned char)s[i];
+static TermCaps tui_caps_cache;
+#ifdef TUI_NO_THREADS
+static bool tui_caps_ok = false;
+#endif
 
-        if (c == 27) { // Início de sequência ANSI
-            in_escape = true;
-        } else if (in_escape) {
-            // Termina sequência ANSI em 'm' ou letras (geralmente)
-            if (c == 'm' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
-                in_escape = false;
-            }
-        } else {
-            // Conta apenas bytes iniciais de caracteres UTF-8
-            if ((c & 0xC0) != 0x80) {
-                length++;
-            }
+#ifndef _WIN32
+// Lê 'max_colors' e a presença de 'repeat_char' do terminfo compilado de 'term'
+static bool tui_terminfo(const char* term, int* colors, bool* rep) {
+    const char* dirs[6];
+    int nd = 0;
+    char home[512];
+    const char* e = getenv("TERMINFO");
+    if (e) dirs[nd++] = e;
+    e = getenv("HOME");
+    if (e && snprintf(home, sizeof(home), "%s/.terminfo", e) < (int)sizeof(home)) dirs[nd++] = home;
+    dirs[nd++] = "/etc/terminfo";
+    dirs[nd++] = "/lib/terminfo";
+    dirs[nd++] = "/usr/share/terminfo";
+
+    unsigned char buf[8192];
+    size_t n = 0;
+    for (int i = 0; i < nd && n == 0; i++) {
+        char path[1024];
+        // Subdiretório pela primeira letra (Linux) ou pelo seu código hexa (macOS)
+        for (int hexa = 0; hexa < 2 && n == 0; hexa++) {
+            if (hexa) snprintf(path, sizeof(path), "%s/%02x/%s", dirs[i], (unsigned char)term[0], term);
+            else snprintf(path, sizeof(path), "%s/%c/%s", dirs[i], term[0], term);
+            FILE* f = fopen(path, "rb");
+            if (!f) continue;
+            n = fread(buf, 1, sizeof(buf), f);
+            fclose(f);
         }
     }
-    return length;
+    if (n < 12) return false;
+
+    // Cabeçalho: magic, tamanho dos nomes, nº de booleanos, números, strings, tabela
+    #define TI_SHORT(p) ((int)(short)((p)[0] | ((p)[1] << 8)))
+    int magic = TI_SHORT(buf);
+    int num_size = magic == 01036 ? 4 : 2;
+    if (magic != 0432 && magic != 01036) return false;
+    size_t names = TI_SHORT(buf + 2), bools = TI_SHORT(buf + 4);
+    size_t nums = TI_SHORT(buf + 6), strs = TI_SHORT(buf + 8);
+    size_t pos = 12 + names + bools;
+    if (pos & 1) pos++;
+    size_t str_pos = pos + nums * num_size;
+    if (str_pos + strs * 2 > n) return false;
+
+    *colors = -1;
+    if (nums > 13) {
+        const unsigned char* p = buf + pos + 13 * num_size;
+        *colors = num_size == 4 ? (int)(p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned)p[3] << 24)) : TI_SHORT(p);
+    }
+    *rep = strs > 121 && TI_SHORT(buf + str_pos + 121 * 2) >= 0;
+    #undef TI_SHORT
+    return true;
 }
+#endif
 
-// Move o cursor utilizando o buffer do Renderer
-void interface_move_cursor(Renderer* r, int y, int x) {
-    char buffer[32];
-    int len = sprintf(buffer, "\033[%d;%dH", y, x);
-    renderer_add_raw(r, buffer, len);
+// Detecta as capacidades do terminal do processo (sem E/S no terminal)
+static void tui_caps_probe(TermCaps* c) {
+    memset(c, 0, sizeof(*c));
+    const char* term = getenv("TERM");
+    const char* colorterm = getenv("COLORTERM");
+    const char* program = getenv("TERM_PROGRAM");
+    bool truecolor = colorterm && (strcmp(colorterm, "truecolor") == 0 || strcmp(colorterm, "24bit") == 0);
+#ifdef _WIN32
+    DWORD modo;
+    c->is_tty = GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &modo) != 0;
+    c->color = truecolor || getenv("WT_SESSION") ? CAP_COLOR_TRUE : CAP_COLOR_256;
+    (void)term;
+    (void)program;
+#else
+    c->is_tty = isatty(STDOUT_FILENO) != 0;
+    if (!term || !*term || strcmp(term, "dumb") == 0) {
+        c->color = CAP_COLOR_NONE;
+    } else {
+        int colors = -1;
+        bool rep = false;
+        bool ti = tui_terminfo(term, &colors, &rep);
+        if (!ti) colors = strstr(term, "256color") ? 256 : 8;
+        c->color = colors >= 256 ? CAP_COLOR_256 : colors >= 8 ? CAP_COLOR_16 : CAP_COLOR_NONE;
+        if (truecolor) c->color = CAP_COLOR_TRUE;
+        c->rep = rep;
+
+        // Atualização sincronizada (modo 2026): terminais conhecidos por suportá-la
+        static const char* const sync_terms[] = { "xterm-kitty", "foot", "alacritty", "xterm-ghostty", "contour" };
+        static const char* const sync_progs[] = { "WezTerm", "iTerm.app", "ghostty", "contour" };
+        for (size_t i = 0; i < sizeof(sync_terms) / sizeof(sync_terms[0]); i++) {
+            if (strncmp(term, sync_terms[i], strlen(sync_terms[i])) == 0) c->sync = true;
+        }
+        for (size_t i = 0; program && i < sizeof(sync_progs) / sizeof(sync_progs[0]); i++) {
+            if (strcmp(program, sync_progs[i]) == 0) c->sync = true;
+        }
+    }
+#endif
+    if (getenv("NO_COLOR")) c->color = CAP_COLOR_NONE;
 }
 
-// Quebra o texto em linhas baseado na largura (Word Wrap)
-char** simple_word_wrap(const char* text, int width, int* num_lines) {
-    int capacity = 16;
-    char** lines = (char**)malloc(capacity * sizeof(char*));
-    *num_lines = 0;
+// A detecção roda uma única vez mesmo com várias threads chegando juntas (ex.: painéis
+// emitindo a primeira cor)
+#ifdef TUI_NO_THREADS
+static void tui_caps_init(void) {
+    if (!tui_caps_ok) tui_caps_probe(&tui_caps_cache);
+    tui_caps_ok = true;
+}
+#elif defined(_WIN32)
+static INIT_ONCE tui_caps_once = INIT_ONCE_STATIC_INIT;
 
-    const char* ptr = text;
-    size_t len = strlen(text);
-    const char* end = text + len;
+static BOOL CALLBACK tui_caps_once_fn(PINIT_ONCE once, PVOID param, PVOID* ctx) {
+    (void)once; (void)param; (void)ctx;
+    tui_caps_probe(&tui_caps_cache);
+    return TRUE;
+}
 
-    while (ptr < end) {
-        // Ignora espaços no início da linha
-        while (ptr < end && *ptr == ' ') ptr++;
-        if (ptr >= end) break;
+static void tui_caps_init(void) {
+    InitOnceExecuteOnce(&tui_caps_once, tui_caps_once_fn, NULL, NULL);
+}
+#else
+static pthread_once_t tui_caps_once = PTHREAD_ONCE_INIT;
 
-        const char* line_start = ptr;
-        const char* line_end = line_start;
-        int current_width = 0;
+static void tui_caps_once_fn(void) {
+    tui_caps_probe(&tui_caps_cache);
+}
 
-        // Processa palavras até preencher a largura ou encontrar quebra
-        while (ptr < end && *ptr != '\n') {
-            const char* word_start = ptr;
-            int word_len_visible = 0;
-            const char* word_end = ptr;
+static void tui_caps_init(void) {
+    pthread_once(&tui_caps_once, tui_caps_once_fn);
+}
+#endif
 
-            // Calcula tamanho visual da palavra atual
-            while (word_end < end && *word_end != ' ' && *word_end != '\n') {
-                if ((*word_end & 0xC0) != 0x80) word_len_visible++;
-                word_end++;
-            }
-            
-            int spaces = (line_end == line_start) ? 0 : 1;
-            
-            // Verifica se a palavra cabe na linha atual
-            if (current_width + spaces + word_len_visible <= width) {
-                current_width += spaces + word_len_visible;
-                line_end = word_end;
-                ptr = word_end;
-                if (ptr < end && *ptr == ' ') ptr++; 
-            } else {
-                break; // Não cabe, força nova linha
-            }
-        }
-        
-        // Trata caso de palavra única maior que a largura total
-        if (line_end == line_start && ptr < end) {
-             while (ptr < end && *ptr != ' ' && *ptr != '\n' && current_width < width) {
-                ptr++;
-                current_width++;
-             }
-             line_end = ptr;
-        }
+// Capacidades do terminal do processo (detectadas uma única vez)
+const TermCaps* tui_caps(void) {
+    tui_caps_init();
+    return &tui_caps_cache;
+}
 
-        // Aloca e copia a linha finalizada para o array
-        int line_bytes = (int)(line_end - line_start);
-        char* line_str = (char*)malloc(line_bytes + 1);
-        memcpy(line_str, line_start, line_bytes);
-        line_str[line_bytes] = '\0';
+// Substitui as capacidades detectadas (configuração do usuário, testes). Chame antes
+// de criar threads que desenham: a troca não é sincronizada com quem está lendo.
+void tui_caps_set(const TermCaps* caps) {
+    tui_caps_init();
+    tui_caps_cache = *caps;
+}
 
-        // Expande array de linhas se necessário
-        if (*num_lines >= capacity) {
-            capacity *= 2;
-            lines = (char**)realloc(lines, capacity * sizeof(char*));
-        }
-        lines[*num_lines] = line_str;
-        (*num_lines)++;
+#ifndef TUI_NO_THREADS
+// Primitivas de thread (usadas pelo pool de montagem de quadros)
+#ifdef _WIN32
+#define TUI_THREAD_FN(nome, arg) static DWORD WINAPI nome(LPVOID arg)
+#define TUI_THREAD_RET 0
 
-        if (ptr < end && *ptr == '\n') ptr++;
-    }
+static void tui_mutex_init(tui_mutex* m) { InitializeCriticalSection(m); }
+static void tui_mutex_destroy(tui_mutex* m) { DeleteCriticalSection(m); }
+static void tui_mutex_lock(tui_mutex* m) { EnterCriticalSection(m); }
+static void tui_mutex_unlock(tui_mutex* m) { LeaveCriticalSection(m); }
+static void tui_cond_init(tui_cond* c) { InitializeConditionVariable(c); }
+static void tui_cond_destroy(tui_cond* c) { (void)c; }
+static void tui_cond_wait(tui_cond* c, tui_mutex* m) { SleepConditionVariableCS(c, m, INFINITE); }
+static void tui_cond_broadcast(tui_cond* c) { WakeAllConditionVariable(c); }
+static bool tui_thread_start(tui_thread* t, LPTHREAD_START_ROUTINE fn, void* arg) {
+    *t = CreateThread(NULL, 0, fn, arg, 0, NULL);
+    return *t != NULL;
+}
+static void tui_thread_join(tui_thread t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+static int tui_cpu_count(void) {
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (int)si.dwNumberOfProcessors;
+}
+#else
+#define TUI_THREAD_FN(nome, arg) static void* nome(void* arg)
+#define TUI_THREAD_RET NULL
 
-    return lines;
+static void tui_mutex_init(tui_mutex* m) { pthread_mutex_init(m, NULL); }
+static void tui_mutex_destroy(tui_mutex* m) { pthread_mutex_destroy(m); }
+static void tui_mutex_lock(tui_mutex* m) { pthread_mutex_lock(m); }
+static void tui_mutex_unlock(tui_mutex* m) { pthread_mutex_unlock(m); }
+static void tui_cond_init(tui_cond* c) { pthread_cond_init(c, NULL); }
+static void tui_cond_destroy(tui_cond* c) { pthread_cond_destroy(c); }
+static void tui_cond_wait(tui_cond* c, tui_mutex* m) { pthread_cond_wait(c, m); }
+static void tui_cond_broadcast(tui_cond* c) { pthread_cond_broadcast(c); }
+static bool tui_thread_start(tui_thread* t, void* (*fn)(void*), void* arg) {
+    return pthread_create(t, NULL, fn, arg) == 0;
+}
+static void tui_thread_join(tui_thread t) {
+    pthread_join(t, NULL);
+}
+static int tui_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
 }
+#endif
+#endif // TUI_NO_THREADS
 
-// Libera a memória da matriz de strings criada pelo word wrap
-void free_wrapped_lines(char** lines, int count) {
-    for (int i = 0; i < count; i++) free(lines[i]);
-    free(lines);
+#ifndef TUI_NO_RECORDER
+// ---------------------------------------------------------------------------
+// Gravação de sessão: log binário com a saída de cada render e os eventos de entrada.
+// Formato: "TUIREC" + versão (1 byte), seguido de registros
+//   [tipo: 1 byte][delta de tempo em us: varint][tamanho: varint][dados]
+// O delta é relativo ao registro anterior; tipos desconhecidos podem ser pulados.
+// ---------------------------------------------------------------------------
+
+#define REC_MAGIC "TUIREC"
+#define REC_VERSION 3   // 1: colagem era REC_INPUT com key = 0; 2: KEY_EXT era 1000+
+
+// Codifica 'v' em varint (7 bits por byte); retorna os bytes usados
+static size_t rec_varint(uint64_t v, unsigned char* out) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (unsigned char)v;
+    return n;
 }
 
-// Preenche uma área retangular com espaços e cor de fundo (limpeza visual)
-void interface_clear(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* bg_color) {
-    if (!bg_color) bg_color = "\033[40m";
-    
-    // Cria linha de espaços
-    char* spaces = (char*)malloc(width + 3);
-    memset(spaces, ' ', width + 2);
-    spaces[width + 2] = '\0';
+// Abre (trunca) o arquivo de gravação e escreve o cabeçalho
+Recorder* recorder_create(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return NULL;
+    Recorder* rec = (Recorder*)malloc(sizeof(Recorder));
+    if (!rec) {
+        fclose(f);
+        return NULL;
+    }
+    rec->f = f;
+    rec->last_us = tui_now_us();
+    rec->frame = NULL;
+    rec->frame_len = 0;
+    rec->frame_cap = 0;
+    rec->error = false;
+    fwrite(REC_MAGIC, 1, 6, f);
+    fputc(REC_VERSION, f);
+    return rec;
+}
 
-    for (int i = 0; i < height + 2; i++) {
-        interface_move_cursor(r, y + i, x);
-        renderer_add(r, bg_color);
-        renderer_add(r, spaces);
-        renderer_add(r, ui->B_RESET);
+// Grava um registro com o instante atual
+void recorder_write(Recorder* rec, int type, const void* data, size_t len) {
+    if (!rec || rec->error) return;
+    uint64_t agora = tui_now_us();
+    unsigned char cab[1 + 10 + 10];
+    size_t n = 0;
+    cab[n++] = (unsigned char)type;
+    n += rec_varint(agora - rec->last_us, cab + n);
+    n += rec_varint(len, cab + n);
+    rec->last_us = agora;
+    if (fwrite(cab, 1, n, rec->f) != n || (len && fwrite(data, 1, len, rec->f) != len)) {
+        rec->error = true;
     }
-    free(spaces);
 }
 
-// Desenha uma caixa com bordas, título e texto estático centralizado
-void interface_draw(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* title, const char* text_line, const char* bg_color, const char* border_color, const char* text_color) {    
-    // Configurações padrão de cor
-    if (!bg_color) bg_color = "";
-    if (!border_color) border_color = "\033[37m";
-    if (!text_color) text_color = "\033[37m";
+// Acumula bytes efetivamente escritos pelo render em andamento
+static void recorder_out(Recorder* rec, const char* dados, size_t len) {
+    if (!rec || rec->error || len == 0) return;
+    if (rec->frame_len + len > rec->frame_cap) {
+        size_t nova = rec->frame_cap ? rec->frame_cap * 2 : 4096;
+        while (nova < rec->frame_len + len) nova *= 2;
+        char* temp = (char*)realloc(rec->frame, nova);
+        if (!temp) {
+            rec->error = true;
+            return;
+        }
+        rec->frame = temp;
+        rec->frame_cap = nova;
+    }
+    memcpy(rec->frame + rec->frame_len, dados, len);
+    rec->frame_len += len;
+}
 
-    // Caracteres de borda dupla (UTF-8)
-    const char* TL = "\xE2\x95\x94";
-    const char* H  = "\xE2\x95\x90";
-    const char* TR = "\xE2\x95\x97";
-    const char* V  = "\xE2\x95\x91";
-    const char* BL = "\xE2\x95\x9A";
-    const char* BR = "\xE2\x95\x9D";
+// Fecha o quadro atual como um registro REC_FRAME
+static void recorder_end_frame(Recorder* rec) {
+    if (!rec || rec->frame_len == 0) return;
+    recorder_write(rec, REC_FRAME, rec->frame, rec->frame_len);
+    rec->frame_len = 0;
+}
 
-    // --- 1. Topo da caixa ---
-    interface_move_cursor(r, y, x);
-    renderer_add(r, bg_color);
-    renderer_add(r, border_color);
-    renderer_add(r, TL);
+// Descarrega e fecha a gravação
+void recorder_destroy(Recorder* rec) {
+    if (!rec) return;
+    fclose(rec->f);
+    free(rec->frame);
+    free(rec);
+}
+#else
+#define recorder_out(rec, dados, len) ((void)0)
+#define recorder_end_frame(rec) ((void)0)
+#define recorder_input(rec, ev) ((void)0)
+#endif
 
-    // Insere título se houver espaço
-    if (title && strlen(title) > 0) {
-        int t_len = interface_visible_len(title);
-        if (t_len + 2 < width) {
-            renderer_add(r, " ");
-            renderer_add(r, title);
-            renderer_add(r, " ");
-            for (int i = 0; i < width - t_len - 2; i++) renderer_add(r, H);
-        } else {
-            renderer_add(r, title);
-        }
+// Escreve tudo o que puder em 'out'. Retorna 0, 1 se a saída não-bloqueante encheu
+// ou -1 em erro; 'feito' recebe os bytes aceitos.
+static int tui_write(tui_fd out, const char* dados, size_t tamanho, size_t* feito) {
+#ifdef _WIN32
+    DWORD escritos = 0, modo;
+    if (GetConsoleMode(out, &modo)) {
+        WriteConsoleA(out, dados, (DWORD)tamanho, &escritos, NULL);
     } else {
-        for (int i = 0; i < width; i++) renderer_add(r, H);
+        WriteFile(out, dados, (DWORD)tamanho, &escritos, NULL);
     }
-    renderer_add(r, TR);
-    renderer_add(r, ui->B_RESET);
-
-    // Prepara o texto interno
-    int num_lines = 0;
-    char** lines = NULL;
-    if (text_line && strlen(text_line) > 0) {
-        lines = simple_word_wrap(text_line, width, &num_lines); 
+    *feito = tamanho;
+    return 0;
+#else
+    *feito = 0;
+    while (*feito < tamanho) {
+        ssize_t n = write(out, dados + *feito, tamanho - *feito);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 1;
+            return -1;
+        }
+        *feito += (size_t)n;
     }
+    return 0;
+#endif
+}
 
-    // --- 2. Corpo da caixa ---
-    for (int i = 0; i < height; i++) {
-        interface_move_cursor(r, y + i + 1, x);
-        renderer_add(r, bg_color);
-        renderer_add(r, border_color);
-        renderer_add(r, V);
-        renderer_add(r, text_color);
+#ifndef TUI_NO_LINES
+// Saída em linhas: a saída do renderer é interpretada em uma grade fora da tela
+// (posicionamento, SGR e REP) e as linhas prontas são escritas de cima para baixo
 
-        int padding = width;
-        if (i < num_lines) {
-            int len = interface_visible_len(lines[i]);
-            if (len > width) {
-                renderer_add(r, lines[i]); 
-                padding = 0;
-            } else {
-                renderer_add(r, lines[i]);
-                padding = width - len;
+// Célula da grade: glifo UTF-8 (vazio = nunca escrita) e estilo
+typedef struct {
+    char g[4];
+    uint16_t style;     // Índice em 'styles' (0 = sem atributos)
+} LineCell;
+
+struct LineGrid {
+    tui_fd out;
+    int width;          // Colunas guardadas (o resto da linha é cortado)
+    int max_rows;       // Linhas guardadas; as mais antigas saem ao passar disto
+    bool sgr;           // Mantém cores/atributos na saída
+    bool error;         // Falha de escrita ou alocação
+
+    LineCell* cells;    // max_rows * width, circular por linha
+    int base;           // Linha da tela (1..) guardada na posição 'first'
+    int first;          // Posição circular da linha 'base'
+    int used;           // Linhas em uso a partir de 'base'
+
+    char** styles;      // Sequências SGR acumuladas, uma por estilo
+    int style_count;
+    char cur[128];      // SGR desde o último reset
+    size_t cur_len;
+    int cur_style;      // Índice de 'cur' (-1 = ainda não registrado)
+
+    // Estado do interpretador (sequências podem chegar partidas)
+    int y, x;
+    int state;          // 0 = texto, 1 = após ESC, 2 = dentro de CSI
+    char esc[32];
+    size_t esc_len;
+    char glyph[4];
+    int glyph_len, glyph_need;
+    LineCell last;      // Último glifo escrito (para REP)
+
+    char* line;         // Linha montada para escrita
+    size_t line_cap;
+};
+
+static LineCell* lines_row(LineGrid* lg, int i) {
+    return lg->cells + (size_t)((lg->first + i) % lg->max_rows) * lg->width;
+}
+
+// Monta e escreve a linha 'base' e a libera para reuso
+static void lines_emit_first(LineGrid* lg) {
+    LineCell* row = lines_row(lg, 0);
+    int fim = lg->width;
+    while (fim > 0 && (row[fim - 1].g[0] == '\0' || row[fim - 1].g[0] == ' ') &&
+           (!lg->sgr || row[fim - 1].style == 0)) fim--;
+
+    size_t len = 0;
+    int style = 0;
+    for (int i = 0; i <= fim; i++) {
+        // Pior caso por célula: reset, estilo e glifo
+        size_t max = 4 + 4 + (lg->sgr ? sizeof(lg->cur) : 0) + 1;
+        if (len + max > lg->line_cap) {
+            size_t nova = lg->line_cap ? lg->line_cap * 2 : 256;
+            while (nova < len + max) nova *= 2;
+            char* temp = (char*)realloc(lg->line, nova);
+            if (!temp) {
+                lg->error = true;
+                return;
             }
+            lg->line = temp;
+            lg->line_cap = nova;
         }
-
-        // Preenche o resto da linha com espaços
-        while (padding > 0) {
-            renderer_add(r, " ");
-            padding--;
+        int st = i < fim ? row[i].style : 0;
+        if (lg->sgr && st != style) {
+            if (style != 0) { memcpy(lg->line + len, "\033[0m", 4); len += 4; }
+            if (st != 0) {
+                size_t n = strlen(lg->styles[st]);
+                memcpy(lg->line + len, lg->styles[st], n);
+                len += n;
+            }
+            style = st;
+        }
+        if (i == fim) break;
+        if (row[i].g[0] == '\0') {
+            lg->line[len++] = ' ';
+        } else {
+            size_t n = (size_t)get_utf8_char_len((unsigned char)row[i].g[0]);
+            memcpy(lg->line + len, row[i].g, n);
+            len += n;
         }
-
-        renderer_add(r, border_color);
-        renderer_add(r, V);
-        renderer_add(r, ui->B_RESET);
     }
-    if (lines) free_wrapped_lines(lines, num_lines);
+    lg->line[len++] = '\n';
 
-    // --- 3. Base da caixa ---
-    interface_move_cursor(r, y + height + 1, x);
-    renderer_add(r, bg_color);
-    renderer_add(r, border_color);
-    renderer_add(r, BL);
-    for (int i = 0; i < width; i++) renderer_add(r, H);
-    renderer_add(r, BR);
-    renderer_add(r, ui->B_RESET);
+    size_t feito;
+    if (tui_write(lg->out, lg->line, len, &feito) != 0) lg->error = true;
+
+    memset(row, 0, (size_t)lg->width * sizeof(LineCell));
+    lg->first = (lg->first + 1) % lg->max_rows;
+    lg->base++;
+    if (lg->used > 0) lg->used--;
 }
 
-// Auxiliar para detectar bytes de caractere UTF-8
-int get_utf8_char_len(unsigned char c) {
-    if ((c & 0x80) == 0) return 1;        // ASCII (1 byte)
-    if ((c & 0xE0) == 0xC0) return 2;     // 2 bytes
-    if ((c & 0xF0) == 0xE0) return 3;     // 3 bytes
-    if ((c & 0xF8) == 0xF0) return 4;     // 4 bytes
-    return 1; // Fallback
+// Célula da posição atual (NULL se fora da grade ou em linha já escrita)
+static LineCell* lines_cell(LineGrid* lg) {
+    if (lg->y < lg->base || lg->x < 1 || lg->x > lg->width) return NULL;
+    while (lg->y >= lg->base + lg->max_rows) lines_emit_first(lg);
+    int i = lg->y - lg->base;
+    if (i >= lg->used) lg->used = i + 1;
+    return lines_row(lg, i) + (lg->x - 1);
 }
 
-// Caixa de diálogo estilo RPG: digitação letra por letra, paginação e skip
-void interface_drawspeak(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* title, const char* texto, const char* bg_color, const char* border_color, const char* text_color, float speed) {
-    
-    if (!bg_color) bg_color = "\033[40m";
-    if (!text_color) text_color = "\033[37m";
+// Índice do estilo atual, registrando-o se for novo
+static int lines_style(LineGrid* lg) {
+    if (lg->cur_style >= 0) return lg->cur_style;
+    if (lg->cur_len == 0) return lg->cur_style = 0;
+    for (int i = 1; i < lg->style_count; i++) {
+        if (strcmp(lg->styles[i], lg->cur) == 0) return lg->cur_style = i;
+    }
+    if (lg->style_count >= UINT16_MAX) return 0;
+    char** temp = (char**)realloc(lg->styles, (size_t)(lg->style_count + 1) * sizeof(char*));
+    char* copia = (char*)malloc(lg->cur_len + 1);
+    if (temp) lg->styles = temp;
+    if (!temp || !copia) {
+        free(copia);
+        lg->error = true;
+        return 0;
+    }
+    memcpy(copia, lg->cur, lg->cur_len + 1);
+    lg->styles[lg->style_count] = copia;
+    return lg->cur_style = lg->style_count++;
+}
 
-    // Quebra todo o texto antes de começar
-    int total_lines = 0;
-    char** wrapped_lines = simple_word_wrap(texto, width, &total_lines);
-    
-    DWORD sleep_ms = (DWORD)(speed * 1000);
-    bool pular_animacao = false;
+static void lines_put(LineGrid* lg, const LineCell* c) {
+    LineCell* dst = lines_cell(lg);
+    if (dst) *dst = *c;
+    lg->x++;
+}
 
-    // Loop de paginação (pula de 'height' em 'height' linhas)
-    for (int i = 0; i < total_lines; i += height) {
-        pular_animacao = false;
-        
-        // Desenha a moldura vazia
-        interface_draw(ui, r, x, y, height, width, title, "", bg_color, border_color, text_color);
-        renderer_render(r);
-        
-        int lines_in_page = (total_lines - i) > height ? height : (total_lines - i);
+// Executa a sequência CSI guardada em 'esc' (parâmetros e byte final)
+static void lines_csi(LineGrid* lg) {
+    char final = lg->esc[lg->esc_len - 1];
+    lg->esc[lg->esc_len - 1] = '\0';
+    if (lg->esc[0] == '?') return; // Modos privados (cursor, colagem, sincronização)
 
-        // Processa cada linha da página atual
-        for (int l = 0; l < lines_in_page; l++) {
-            char* line = wrapped_lines[i + l];
-            int pos_y = y + 1 + l;
-            int pos_x = x + 1;
+    int a = atoi(lg->esc);
+    const char* sep = strchr(lg->esc, ';');
+    int b = sep ? atoi(sep + 1) : 0;
+    switch (final) {
+        case 'H':
+        case 'f':
+            lg->y = a > 0 ? a : 1;
+            lg->x = b > 0 ? b : 1;
+            break;
+        case 'b':
+            if (lg->last.g[0]) {
+                for (int i = 0; i < (a > 0 ? a : 1) && lg->x <= lg->width; i++) lines_put(lg, &lg->last);
+            }
+            break;
+        case 'm':
+            if (a == 0) {
+                lg->cur_len = 0;
+                lg->cur[0] = '\0';
+            }
+            if (a != 0 || sep) {
+                char seq[sizeof(lg->esc) + 3];
+                size_t n = (size_t)sprintf(seq, "\033[%sm", lg->esc);
+                // Repetida no fim: nada muda; sem espaço, recomeça só com a nova
+                if (lg->cur_len >= n && memcmp(lg->cur + lg->cur_len - n, seq, n) == 0) break;
+                if (lg->cur_len + n >= sizeof(lg->cur)) lg->cur_len = 0;
+                memcpy(lg->cur + lg->cur_len, seq, n + 1);
+                lg->cur_len += n;
+            }
+            lg->cur_style = -1;
+            break;
+        default:
+            break;
+    }
+}
 
-            // Se usuário pulou, imprime a linha inteira de uma vez
-            if (pular_animacao) {
-                interface_move_cursor(r, pos_y, pos_x);
-                renderer_add(r, bg_color);
-                renderer_add(r, text_color);
-                renderer_add(r, line);
-                renderer_render(r);
-                continue;
+// Interpreta bytes da saída do renderer
+static int lines_feed(LineGrid* lg, const char* dados, size_t tamanho) {
+    for (size_t i = 0; i < tamanho; i++) {
+        unsigned char c = (unsigned char)dados[i];
+        if (lg->state == 1) {
+            lg->state = c == '[' ? 2 : 0;
+            lg->esc_len = 0;
+            continue;
+        }
+        if (lg->state == 2) {
+            if (lg->esc_len < sizeof(lg->esc) - 1) lg->esc[lg->esc_len++] = (char)c;
+            if (c >= 0x40 && c <= 0x7E) {
+                lines_csi(lg);
+                lg->state = 0;
             }
-            
-            // Efeito de digitação caractere por caractere
-            size_t len = strlen(line);
-            for (size_t k = 0; k < len; ) {
-                interface_move_cursor(r, pos_y, pos_x);
-                renderer_add(r, bg_color);
-                renderer_add(r, text_color);
-                
-                unsigned char c = (unsigned char)line[k];
-                int char_bytes = get_utf8_char_len(c);
-                
-                renderer_add_raw(r, &line[k], char_bytes);
-                renderer_render(r); // Renderiza imediatamente
+            continue;
+        }
+        if (lg->glyph_need > 0 && (c & 0xC0) == 0x80) {
+            lg->glyph[lg->glyph_len++] = (char)c;
+            if (--lg->glyph_need > 0) continue;
+        } else if (c == 0x1b) {
+            lg->state = 1;
+            continue;
+        } else if (c == '\n') {
+            lg->y++;
+            lg->x = 1;
+            continue;
+        } else if (c == '\r') {
+            lg->x = 1;
+            continue;
+        } else if (c < 0x20) {
+            continue;
+        } else {
+            lg->glyph[0] = (char)c;
+            lg->glyph_len = 1;
+            lg->glyph_need = get_utf8_char_len(c) - 1;
+            if (lg->glyph_need > 0) continue;
+        }
+        lg->glyph_need = 0;
+        memset(&lg->last, 0, sizeof(lg->last));
+        memcpy(lg->last.g, lg->glyph, (size_t)lg->glyph_len);
+        lg->last.style = (uint16_t)(lg->sgr ? lines_style(lg) : 0);
+        lines_put(lg, &lg->last);
+    }
+    return lg->error ? -1 : 0;
+}
 
-                k += char_bytes;
-                pos_x++; 
+static void lines_destroy(LineGrid* lg) {
+    for (int i = 1; i < lg->style_count; i++) free(lg->styles[i]);
+    free(lg->styles);
+    free(lg->cells);
+    free(lg->line);
+    free(lg);
+}
+#endif
 
-                Sleep(sleep_ms);
+// Sequências longas pré-montadas, referenciadas em vez de copiadas
+#define RUN_ESP_16 "                "
+#define RUN_ESP_128 RUN_ESP_16 RUN_ESP_16 RUN_ESP_16 RUN_ESP_16 RUN_ESP_16 RUN_ESP_16 RUN_ESP_16 RUN_ESP_16
+#define RUN_H_8 "\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90"
+#define RUN_H_64 RUN_H_8 RUN_H_8 RUN_H_8 RUN_H_8 RUN_H_8 RUN_H_8 RUN_H_8 RUN_H_8
 
-                // Detecta tecla para pular animação
-                if (_kbhit()) {
-                    _getch(); // Consome tecla
-                    pular_animacao = true;
-                    // Completa o restante da linha atual
-                    if (k < len) {
-                        renderer_add(r, &line[k]); 
-                        renderer_render(r);
-                    }
-                    break; 
-                }
-            }
-        }
+static const char RUN_ESPACOS[] = RUN_ESP_128 RUN_ESP_128;
+static const char RUN_BORDA_H[] = RUN_H_64 RUN_H_64;
 
-        // Indicador de "Próxima Página" (seta para baixo)
-        interface_move_cursor(r, y + height, x + width);
-        renderer_add(r, bg_color);
-        renderer_add(r, border_color);
-        renderer_add(r, "\xE2\x96\xBC"); 
-        renderer_add(r, ui->B_RESET);
-        renderer_render(r);
+// Inicializa um renderizador que escreve em um descritor/handle arbitrário (pty, socket, arquivo)
+Renderer* renderer_create_fd(tui_fd out, size_t initial_capacity) {
+    Renderer* r = (Renderer*)malloc(sizeof(Renderer));
+    if (!r) return NULL;
 
-        // Espera interação do usuário (Enter, Espaço ou Z)
-        while (true) {
-            Sleep(50);
-            if (_kbhit()) {
-                int key = _getch();
-                if (key == 13 || key == 32 || key == 'z' || key == 'Z') break;
-            }
-        }
+    // O buffer só é alocado na primeira adição
+    if (initial_capacity < 256) initial_capacity = 256;
+    r->capacity = 0;
+    r->initial_capacity = initial_capacity;
+    r->buffer = NULL;
+    r->size = 0;
+    r->out = out;
+    r->blocked = false;
+
+    r->segs = NULL;
+    r->seg_count = 0;
+    r->seg_capacity = 0;
+    r->seg_start = 0;
+    r->zero_copy = false;
+    r->zc_min = 256;
+
+    r->max_capacity = 0;
+    r->shrink_high_water = 0;
+    r->auto_flush = false;
+    r->error = false;
+    r->rec = NULL;
+
+    r->caps = NULL;
+    r->caps_auto = false;
+    r->in_frame = false;
+    r->setup_console = false;
+    r->lines = NULL;
+
+    r->frame_fn = NULL;
+    r->frame_user = NULL;
+    r->dirty = false;
+    r->frame_last = 0;
+    r->frame_min = 16000;
+    r->frame_max = 250000;
+    r->frame_interval = r->frame_min;
+    r->write_avg = 0;
+    return r;
+}
+
+// Inicializa o renderizador na saída padrão com capacidade inicial configurável.
+// O console (UTF-8) e as capacidades do terminal só são tratados no primeiro uso.
+Renderer* renderer_create_ex(size_t initial_capacity) {
+    Renderer* r = renderer_create_fd(tui_stdout(), initial_capacity);
+    if (r) {
+        r->caps_auto = true;
+        r->setup_console = true;
     }
+    return r;
+}
 
-    free_wrapped_lines(wrapped_lines, total_lines);
+#ifndef TUI_NO_LINES
+// Inicializa um renderizador em modo de linhas, para saídas que não são terminais
+// (arquivo, pipe, log): cada render compõe a saída numa grade de 'width' colunas e as
+// linhas são escritas em 'out' como texto comum, de cima para baixo, conforme ficam
+// prontas. Só 'max_rows' linhas ficam em memória; ao desenhar abaixo disso as mais
+// antigas são escritas. Sem 'sgr', cores e atributos são descartados.
+Renderer* renderer_create_lines(tui_fd out, int width, int max_rows, bool sgr) {
+    if (width <= 0) width = 80;
+    if (max_rows <= 0) max_rows = 256;
+
+    LineGrid* lg = (LineGrid*)calloc(1, sizeof(LineGrid));
+    if (!lg) return NULL;
+    lg->cells = (LineCell*)calloc((size_t)width * max_rows, sizeof(LineCell));
+    lg->styles = (char**)malloc(sizeof(char*));
+    Renderer* r = lg->cells && lg->styles ? renderer_create_fd(out, 4096) : NULL;
+    if (!r) {
+        free(lg->cells);
+        free(lg->styles);
+        free(lg);
+        return NULL;
+    }
+    lg->styles[0] = NULL;
+    lg->style_count = 1;
+    lg->out = out;
+    lg->width = width;
+    lg->max_rows = max_rows;
+    lg->sgr = sgr;
+    lg->base = 1;
+    lg->y = 1;
+    lg->x = 1;
+    r->lines = lg;
+    return r;
 }
 
-// Variante de interface_draw (estrutura quase idêntica)
-void interface_drawline(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* title, const char* text_line, const char* bg_color, const char* border_color, const char* text_color, const char* border_style) {
-    if (!bg_color) bg_color = "";
-    if (!border_color) border_color = "\033[37m";
-    if (!text_color) text_color = "\033[37m";
-    
-    const char* TL = "\xE2\x95\x94"; const char* H  = "\xE2\x95\x90";
-    const char* TR = "\xE2\x95\x97"; const char* V  = "\xE2\x95\x91";
-    const char* BL = "\xE2\x95\x9A"; const char* BR = "\xE2\x95\x9D";
-    
-    int total_lines = 0;
-    char** lines = NULL;
-    if (text_line && *text_line) {
-        lines = simple_word_wrap(text_line, width, &total_lines);
+// Despeja o quadro pendente e escreve as linhas acima de 'y' (0 = todas as desenhadas);
+// elas não podem mais ser alteradas. Sem efeito fora do modo de linhas.
+int renderer_lines_flush(Renderer* r, int y) {
+    LineGrid* lg = r->lines;
+    if (!lg) return 0;
+    int res = renderer_render(r);
+    while (lg->used > 0 && (y <= 0 || lg->base < y)) lines_emit_first(lg);
+    if (y > lg->base) {
+        // Linhas nunca desenhadas acima de 'y' saem em branco
+        while (lg->base < y) lines_emit_first(lg);
     }
+    return lg->error || res < 0 ? -1 : res;
+}
+#endif
 
-    // Topo
-    interface_move_cursor(r, y, x);
-    renderer_add(r, bg_color);
-    renderer_add(r, border_color);
-    renderer_add(r, TL);
+// Inicializa o renderizador com o buffer padrão de 64KB
+Renderer* renderer_create() {
+    return renderer_create_ex(65536);
+}
 
-    if (title && *title) {
-        int t_len = interface_visible_len(title);
-        if (t_len + 2 < width) {
-            renderer_add(r, " ");
-            renderer_add(r, title);
-            renderer_add(r, " ");
-            for (int k = 0; k < width - t_len - 2; k++) renderer_add(r, H);
-        } else {
-            renderer_add(r, title);
+// Libera toda a memória alocada
+void renderer_destroy(Renderer* r) {
+    if (r) {
+#ifndef TUI_NO_LINES
+        if (r->lines) {
+            renderer_lines_flush(r, 0);
+            lines_destroy(r->lines);
         }
-    } else {
-        for (int k = 0; k < width; k++) renderer_add(r, H);
+#endif
+        if (r->buffer) {
+            free(r->buffer);
+        }
+        free(r->segs);
+        free(r);
     }
-    renderer_add(r, TR);
-    renderer_add(r, ui->B_RESET);
+}
 
-    // Corpo
-    for (int i = 0; i < height; i++) {
-        interface_move_cursor(r, y + i + 1, x);
-        renderer_add(r, bg_color);
-        renderer_add(r, border_color);
-        renderer_add(r, V);
-        renderer_add(r, text_color);
+// Limita o buffer a max_capacity bytes (0 = sem limite). Com auto_flush, o buffer cheio
+// é despejado no meio do quadro em vez de crescer; sem ele, a adição falha.
+void renderer_set_limits(Renderer* r, size_t max_capacity, bool auto_flush) {
+    if (max_capacity > 0 && max_capacity < r->initial_capacity) max_capacity = r->initial_capacity;
+    r->max_capacity = max_capacity;
+    r->auto_flush = auto_flush;
+}
 
-        int padding = width;
-        if (i < total_lines) {
-            int len = interface_visible_len(lines[i]);
-            if (len > width) {
-                 renderer_add(r, lines[i]);
-                 padding = 0;
-            } else {
-                renderer_add(r, lines[i]);
-                padding = width - len;
-            }
+// Após cada render, devolve o buffer à capacidade inicial se ele passou de high_water (0 = nunca)
+void renderer_set_shrink(Renderer* r, size_t high_water) {
+    r->shrink_high_water = high_water;
+}
+
+// Usa as capacidades 'caps' para esta saída (ex.: terminal remoto de uma sessão; NULL = básicas)
+void renderer_set_caps(Renderer* r, const TermCaps* caps) {
+    r->caps = caps;
+    r->caps_auto = false;
+}
+
+// Capacidades da saída; para a saída padrão, detectadas na primeira consulta
+static const TermCaps* renderer_caps(Renderer* r) {
+    if (r->caps_auto) {
+        r->caps = tui_caps();
+        r->caps_auto = false;
+    }
+    return r->caps;
+}
+
+// Indica se alguma adição falhou desde o último render (dados descartados)
+bool renderer_error(const Renderer* r) {
+    return r->error;
+}
+
+// Escreve bytes na saída. Retorna quantos foram aceitos; em saída não-bloqueante
+// cheia retorna menos que 'tamanho' e marca 'blocked'.
+static size_t renderer_write(Renderer* r, const char* dados, size_t tamanho) {
+#ifndef TUI_NO_LINES
+    if (r->lines) {
+        if (lines_feed(r->lines, dados, tamanho) != 0) r->error = true;
+        recorder_out(r->rec, dados, tamanho);
+        return tamanho;
+    }
+#endif
+    size_t feito = 0;
+    int res = tui_write(r->out, dados, tamanho, &feito);
+    if (res > 0) r->blocked = true;
+    else if (res < 0) r->error = true;
+    recorder_out(r->rec, dados, feito);
+    return feito;
+}
+
+// Anexa um trecho à lista de saída (-1 em falha de alocação)
+static int renderer_push_seg(Renderer* r, const char* ref, size_t offset, size_t len) {
+    if (r->seg_count >= r->seg_capacity) {
+        size_t nova = r->seg_capacity ? r->seg_capacity * 2 : 32;
+        RendererSeg* temp = (RendererSeg*)realloc(r->segs, nova * sizeof(RendererSeg));
+        if (!temp) {
+            r->error = true;
+            return -1;
         }
+        r->segs = temp;
+        r->seg_capacity = nova;
+    }
+    r->segs[r->seg_count].ref = ref;
+    r->segs[r->seg_count].offset = offset;
+    r->segs[r->seg_count].len = len;
+    r->seg_count++;
+    return 0;
+}
 
-        while (padding > 0) {
-            renderer_add(r, " ");
-            padding--;
+// Fecha a faixa do buffer próprio acumulada desde o último trecho
+static int renderer_close_run(Renderer* r) {
+    if (r->size > r->seg_start) {
+        if (renderer_push_seg(r, NULL, r->seg_start, r->size - r->seg_start) != 0) return -1;
+        r->seg_start = r->size;
+    }
+    return 0;
+}
+
+// Aplica a política de redução após um quadro despejado
+static void renderer_shrink(Renderer* r) {
+    if (r->shrink_high_water > 0 && r->capacity > r->shrink_high_water) {
+        char* temp = (char*)realloc(r->buffer, r->initial_capacity);
+        if (temp) {
+            r->buffer = temp;
+            r->capacity = r->initial_capacity;
         }
-        renderer_add(r, border_color);
-        renderer_add(r, V);
-        renderer_add(r, ui->B_RESET);
     }
-    
-    // Base
-    interface_move_cursor(r, y + height + 1, x);
-    renderer_add(r, bg_color);
-    renderer_add(r, border_color);
-    renderer_add(r, BL);
-    for (int k = 0; k < width; k++) renderer_add(r, H);
-    renderer_add(r, BR);
-    renderer_add(r, ui->B_RESET);
-    
-    if (lines) free_wrapped_lines(lines, total_lines);
+    if (r->shrink_high_water > 0 && r->seg_capacity * sizeof(RendererSeg) > r->shrink_high_water) {
+        free(r->segs);
+        r->segs = NULL;
+        r->seg_capacity = 0;
+    }
 }
 
-// Escreve texto solto na tela com efeito de digitação (sem moldura)
-void interface_text_speak(Interface* ui, Renderer* r, int x, int y, const char* texto, const char* bg_color, const char* text_color, float speed) {
-    
-    if (!bg_color) bg_color = "\033[40m";
-    if (!text_color) text_color = "\033[37m";
-    
-    DWORD sleep_ms = (DWORD)(speed * 1000);
-    bool pular = false;
-    size_t n = strlen(texto);
+// Mantém como novo buffer os bytes ainda não escritos, a partir do trecho 'seg' deslocado de 'off'
+static void renderer_keep_pending(Renderer* r, size_t seg, size_t off) {
+    size_t total = 0;
+    for (size_t i = seg; i < r->seg_count; i++) total += r->segs[i].len;
+    total -= off;
+    total += r->size - r->seg_start; // Faixa final não registrada
+
+    size_t cap = r->capacity > total ? r->capacity : total + 1;
+    char* novo = (char*)malloc(cap);
+    if (!novo) {
+        r->error = true;
+        r->seg_count = 0;
+        r->seg_start = 0;
+        r->size = 0;
+        return;
+    }
+
+    size_t pos = 0;
+    for (size_t i = seg; i < r->seg_count; i++) {
+        const RendererSeg* s = &r->segs[i];
+        const char* dados = s->ref ? s->ref : r->buffer + s->offset;
+        size_t skip = (i == seg) ? off : 0;
+        memcpy(novo + pos, dados + skip, s->len - skip);
+        pos += s->len - skip;
+    }
+    memcpy(novo + pos, r->buffer + r->seg_start, r->size - r->seg_start);
+
+    free(r->buffer);
+    r->buffer = novo;
+    r->capacity = cap;
+    r->size = total;
+    r->seg_count = 0;
+    r->seg_start = 0;
+}
+
+// Despeja o conteúdo do buffer na saída (ver renderer_render)
+static int renderer_flush(Renderer* r) {
+    r->error = false;
+    r->blocked = false;
+#ifdef _WIN32
+    if (r->setup_console) {
+        // Define codificação do console para suportar caracteres especiais
+        SetConsoleOutputCP(CP_UTF8);
+        SetConsoleCP(CP_UTF8);
+        r->setup_console = false;
+    }
+#endif
+
+    // Caminho simples: tudo está no buffer próprio
+    if (r->seg_count == 0) {
+        if (r->size == 0) return 0;
+        size_t feito = renderer_write(r, r->buffer, r->size);
+        if (feito < r->size && r->blocked) {
+            memmove(r->buffer, r->buffer + feito, r->size - feito);
+            r->size -= feito;
+            r->seg_start = 0;
+            return 1;
+        }
+        r->size = 0;
+        r->seg_start = 0;
+        renderer_shrink(r);
+        return r->error ? -1 : 0;
+    }
+
+    // Modo zero-copy: despeja os trechos em ordem
+    // Se a lista não puder crescer, a faixa final é escrita após os trechos
+    renderer_close_run(r);
+#ifdef _WIN32
+    bool por_trecho = true;
+#else
+    bool por_trecho = r->lines != NULL;
+#endif
+    // O console não tem escrita vetorizada (um WriteConsoleA por trecho), e o modo
+    // de linhas só interpreta os bytes
+    if (por_trecho) {
+        for (size_t i = 0; i < r->seg_count; i++) {
+            const RendererSeg* s = &r->segs[i];
+            const char* dados = s->ref ? s->ref : r->buffer + s->offset;
+            renderer_write(r, dados, s->len);
+        }
+    }
+#ifndef _WIN32
+    // Escrita vetorizada: trechos do buffer e referências saem em uma única chamada
+    size_t seg = 0, off = 0;
+    while (!por_trecho && seg < r->seg_count) {
+        struct iovec iov[64];
+        int n_iov = 0;
+        for (size_t i = seg; i < r->seg_count && n_iov < 64; i++) {
+            const RendererSeg* s = &r->segs[i];
+            const char* dados = s->ref ? s->ref : r->buffer + s->offset;
+            size_t skip = (i == seg) ? off : 0;
+            iov[n_iov].iov_base = (void*)(dados + skip);
+            iov[n_iov].iov_len = s->len - skip;
+            n_iov++;
+        }
+
+        ssize_t n = writev(r->out, iov, n_iov);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                r->blocked = true;
+                renderer_keep_pending(r, seg, off);
+                return 1;
+            }
+            r->error = true;
+            break;
+        }
+
+#ifndef TUI_NO_RECORDER
+        if (r->rec) {
+            size_t gravar = (size_t)n;
+            for (int i = 0; i < n_iov && gravar > 0; i++) {
+                size_t k = iov[i].iov_len < gravar ? iov[i].iov_len : gravar;
+                recorder_out(r->rec, (const char*)iov[i].iov_base, k);
+                gravar -= k;
+            }
+        }
+#endif
+
+        // Avança pelos trechos consumidos (escrita parcial é possível)
+        size_t resto = (size_t)n;
+        while (seg < r->seg_count && resto >= r->segs[seg].len - off) {
+            resto -= r->segs[seg].len - off;
+            seg++;
+            off = 0;
+        }
+        off += resto;
+    }
+#endif
+    if (r->size > r->seg_start && !r->error) {
+        size_t tam = r->size - r->seg_start;
+        size_t feito = renderer_write(r, r->buffer + r->seg_start, tam);
+        if (feito < tam && r->blocked) {
+            memmove(r->buffer, r->buffer + r->seg_start + feito, tam - feito);
+            r->size = tam - feito;
+            r->seg_count = 0;
+            r->seg_start = 0;
+            return 1;
+        }
+    }
+    r->seg_count = 0;
+    r->seg_start = 0;
+    r->size = 0;
+    renderer_shrink(r);
+    return r->error ? -1 : 0;
+}
+
+// Despeja o conteúdo do buffer na saída e reseta o índice.
+// Retorna 0 se tudo foi escrito, 1 se a saída não-bloqueante encheu (o restante
+// fica pendente para o próximo render) e -1 em erro de escrita (quadro descartado).
+int renderer_render(Renderer* r) {
+    if (r->in_frame) {
+        const TermCaps* c = renderer_caps(r);
+        if (c && c->sync) renderer_add_raw(r, "\033[?2026l", 8);
+        r->in_frame = false;
+    }
+    int res = renderer_flush(r);
+    recorder_end_frame(r->rec);
+    return res;
+}
+
+#ifndef TUI_NO_RECORDER
+// Grava a saída de cada render em 'rec' (NULL desliga); o gravador não pertence ao renderer
+void renderer_set_recorder(Renderer* r, Recorder* rec) {
+    r->rec = rec;
+}
+#endif
+
+// Indica se há saída aguardando (quadro em montagem ou resto de escrita bloqueada)
+bool renderer_pending(const Renderer* r) {
+    return r->size > 0 || r->seg_count > 0;
+}
+
+// Configura o governador de quadros: 'fn' redesenha o quadro (NULL = o chamador desenha
+// direto no buffer e só pede o despejo). Os despejos ficam entre 'min_ms' e 'max_ms'
+// de intervalo (<= 0 = 16 e 250), conforme a saída aguenta.
+void renderer_set_frame(Renderer* r, RendererFrameFn fn, void* user, int min_ms, int max_ms) {
+    r->frame_fn = fn;
+    r->frame_user = user;
+    r->frame_min = (uint64_t)(min_ms > 0 ? min_ms : 16) * 1000;
+    r->frame_max = (uint64_t)(max_ms > 0 ? max_ms : 250) * 1000;
+    if (r->frame_max < r->frame_min) r->frame_max = r->frame_min;
+    r->frame_interval = r->frame_min;
+}
+
+// Pede um redesenho; pode ser chamado a qualquer taxa (só marca o quadro como sujo)
+void renderer_invalidate(Renderer* r) {
+    r->dirty = true;
+}
+
+// Ajusta o intervalo pela duração do último despejo: a escrita deve ocupar no máximo
+// metade do tempo; saída cheia dobra o intervalo, e a volta ao normal é gradual
+static void renderer_pace(Renderer* r, uint64_t duracao, bool cheia) {
+    r->write_avg = (r->write_avg * 7 + duracao) / 8;
+    uint64_t alvo = r->write_avg * 2;
+    if (cheia) {
+        r->frame_interval *= 2;
+    } else if (alvo > r->frame_interval) {
+        r->frame_interval = alvo;
+    } else {
+        r->frame_interval = (r->frame_interval * 3 + alvo) / 4;
+    }
+    if (r->frame_interval < r->frame_min) r->frame_interval = r->frame_min;
+    if (r->frame_interval > r->frame_max) r->frame_interval = r->frame_max;
+}
+
+// Despeja um quadro se há pedido pendente e o intervalo já passou; com a saída ainda
+// cheia, só tenta terminar o quadro anterior. Retorna em quantos ms chamar de novo
+// (ex.: como timeout de inputs_next_event) ou -1 se não há nada pendente.
+int renderer_tick(Renderer* r) {
+    bool resto = r->blocked && renderer_pending(r);
+    if (!r->dirty && !resto) return -1;
+
+    uint64_t agora = tui_now_us();
+    uint64_t prox = r->frame_last + r->frame_interval;
+    if (agora < prox) return (int)((prox - agora + 999) / 1000);
+
+    if (!resto) {
+        r->dirty = false;
+        if (r->frame_fn) r->frame_fn(r, r->frame_user);
+    }
+    uint64_t inicio = tui_now_us();
+    int res = renderer_render(r);
+    r->frame_last = tui_now_us();
+    renderer_pace(r, r->frame_last - inicio, res == 1);
+
+    if (res != 1 && !r->dirty) return -1;
+    return (int)((r->frame_interval + 999) / 1000);
+}
+
+// Primeira adição do quadro: aloca o buffer se ainda não existe e, se o terminal
+// suporta, abre a atualização sincronizada (fechada no renderer_render)
+static int renderer_begin_frame(Renderer* r) {
+    if (!r->buffer) {
+        r->buffer = (char*)malloc(r->initial_capacity);
+        if (!r->buffer) {
+            r->error = true;
+            return -1;
+        }
+        r->capacity = r->initial_capacity;
+    }
+    r->in_frame = true;
+    const TermCaps* c = renderer_caps(r);
+    if (c && c->sync) return renderer_add_raw(r, "\033[?2026h", 8);
+    return 0;
+}
+
+// Adiciona dados brutos ao buffer, redimensionando se necessário.
+// Retorna 0 em sucesso e -1 se o limite ou a alocação impediram a adição.
+int renderer_add_raw(Renderer* r, const char* dados, size_t tamanho) {
+    if (!r->in_frame && renderer_begin_frame(r) != 0) return -1;
+    if (r->size + tamanho >= r->capacity) {
+        size_t nova = r->capacity;
+        while (r->size + tamanho >= nova) {
+            nova *= 2;
+        }
+
+        // Limite atingido: cresce até o teto, despeja o quadro parcial ou recusa
+        if (r->max_capacity > 0 && nova > r->max_capacity && r->size + tamanho < r->max_capacity) {
+            nova = r->max_capacity;
+        } else if (r->max_capacity > 0 && nova > r->max_capacity) {
+            if (!r->auto_flush) {
+                r->error = true;
+                return -1;
+            }
+            // Despeja sem fechar o quadro: a atualização sincronizada (se aberta) segue
+            // até o renderer_render, e o terminal não mostra o quadro pela metade
+            bool erro = r->error;
+            renderer_flush(r);
+            r->error = erro;
+
+            nova = r->capacity;
+            // Pedaço maior que o buffer inteiro: vai direto para a saída
+            if (r->size == 0 && tamanho >= r->capacity) {
+                size_t feito = renderer_write(r, dados, tamanho);
+                if (feito == tamanho) return 0;
+                if (!r->blocked) return -1;
+                // Saída não-bloqueante cheia: a cauda fica pendente para o próximo
+                // render, mesmo acima do teto (como em renderer_keep_pending)
+                dados += feito;
+                tamanho -= feito;
+                while (tamanho >= nova) nova *= 2;
+            } else if (r->size + tamanho >= r->capacity) {
+                // Saída não-bloqueante cheia: o que sobrou do despejo ocupa o buffer
+                r->error = true;
+                return -1;
+            }
+        }
+
+        // Expande capacidade (dobra) se o espaço for insuficiente
+        if (nova != r->capacity) {
+            char* temp = (char*)realloc(r->buffer, nova);
+            if (!temp) {
+                r->error = true;
+                return -1;
+            }
+            r->buffer = temp;
+            r->capacity = nova;
+        }
+    }
+
+    // Copia dados para a próxima posição livre
+    memcpy(r->buffer + r->size, dados, tamanho);
+    r->size += tamanho;
+    return 0;
+}
+
+// Wrapper para adicionar strings terminadas em nulo
+int renderer_add(Renderer* r, const char* content) {
+    if (content == NULL) return 0;
+    return renderer_add_raw(r, content, strlen(content));
+}
+
+// Ativa/desativa o registro por referência de dados imutáveis (min_len = 0 mantém o padrão)
+void renderer_set_zero_copy(Renderer* r, bool ativo, size_t min_len) {
+    r->zero_copy = ativo;
+    if (min_len > 0) r->zc_min = min_len;
+}
+
+// Adiciona dados do chamador por referência (sem cópia) quando o modo zero-copy está ativo.
+// Os dados devem permanecer válidos e inalterados até o próximo renderer_render.
+int renderer_add_ref_raw(Renderer* r, const char* dados, size_t tamanho) {
+    if (!r->zero_copy || tamanho < r->zc_min) {
+        return renderer_add_raw(r, dados, tamanho);
+    }
+    if (!r->in_frame && renderer_begin_frame(r) != 0) return -1;
+    if (renderer_close_run(r) != 0) return -1;
+    return renderer_push_seg(r, dados, 0, tamanho);
+}
+
+// Wrapper de renderer_add_ref_raw para strings terminadas em nulo
+int renderer_add_ref(Renderer* r, const char* content) {
+    if (content == NULL) return 0;
+    return renderer_add_ref_raw(r, content, strlen(content));
+}
+
+// Repete um glifo 'count' vezes: com REP no terminal, o glifo uma vez e CSI n b;
+// senão espaços e borda horizontal usam sequências pré-montadas
+void renderer_add_repeat(Renderer* r, const char* glyph, int count) {
+    size_t g = strlen(glyph);
+    if (g == 0 || count <= 0) return;
+
+    const TermCaps* c = renderer_caps(r);
+    if (c && c->rep && (size_t)(count - 1) * g > 6) {
+        char seq[16];
+        renderer_add_raw(r, glyph, g);
+        renderer_add_raw(r, seq, sprintf(seq, "\033[%db", count - 1));
+        return;
+    }
+
+    const char* run = NULL;
+    size_t run_len = 0;
+    if (strcmp(glyph, " ") == 0) {
+        run = RUN_ESPACOS;
+        run_len = sizeof(RUN_ESPACOS) - 1;
+    } else if (strcmp(glyph, "\xE2\x95\x90") == 0) {
+        run = RUN_BORDA_H;
+        run_len = sizeof(RUN_BORDA_H) - 1;
+    }
+
+    if (!run) {
+        for (int i = 0; i < count; i++) renderer_add_raw(r, glyph, g);
+        return;
+    }
+
+    size_t restante = (size_t)count * g;
+    while (restante > 0) {
+        size_t n = restante < run_len ? restante : run_len;
+        renderer_add_ref_raw(r, run, n);
+        restante -= n;
+    }
+}
+
+// Posiciona o cursor usando sequências ANSI
+void renderer_move_cursor(Renderer* r, int y, int x) {
+    char buffer[32];
+    int len = sprintf(buffer, "\033[%d;%dH", y, x);
+    renderer_add_raw(r, buffer, len);
+}
+
+// Descarta o quadro em montagem sem escrevê-lo
+void renderer_discard(Renderer* r) {
+    r->in_frame = false;
+    r->size = 0;
+    r->seg_count = 0;
+    r->seg_start = 0;
+    r->error = false;
+}
+
+// Copia o quadro pendente de 'src' para o fim de 'dst' (src não é alterado)
+int renderer_append(Renderer* dst, const Renderer* src) {
+    int rc = 0;
+    size_t fim = src->seg_start;
+    for (size_t i = 0; i < src->seg_count; i++) {
+        const RendererSeg* s = &src->segs[i];
+        const char* dados = s->ref ? s->ref : src->buffer + s->offset;
+        if (renderer_add_raw(dst, dados, s->len) != 0) rc = -1;
+    }
+    if (src->size > fim && renderer_add_raw(dst, src->buffer + fim, src->size - fim) != 0) rc = -1;
+    return rc;
+}
+
+#ifndef TUI_NO_THREADS
+// ---------------------------------------------------------------------------
+// Painéis: quadros desenhados por threads produtoras, despejados pela thread de render
+// ---------------------------------------------------------------------------
+
+#define PANEL_NOVO 4    // Bit de "quadro publicado ainda não coletado" em 'ready'
+
+// Cria um painel; os buffers não são ligados a nenhuma saída
+RenderPanel* panel_create(size_t initial_capacity) {
+    RenderPanel* p = (RenderPanel*)malloc(sizeof(RenderPanel));
+    if (!p) return NULL;
+    for (int i = 0; i < 3; i++) {
+        p->bufs[i] = renderer_create_fd(TUI_FD_INVALID, initial_capacity);
+        if (!p->bufs[i]) {
+            while (i-- > 0) renderer_destroy(p->bufs[i]);
+            free(p);
+            return NULL;
+        }
+    }
+    p->back = 0;
+    p->front = 1;
+    atomic_init(&p->ready, 2);
+    return p;
+}
+
+// Libera o painel e seus buffers
+void panel_destroy(RenderPanel* p) {
+    if (!p) return;
+    for (int i = 0; i < 3; i++) renderer_destroy(p->bufs[i]);
+    free(p);
+}
+
+// [Thread produtora] Devolve o buffer de desenho vazio. Os dados são copiados na
+// coleta, então referências zero-copy não devem ser usadas aqui.
+Renderer* panel_begin(RenderPanel* p) {
+    Renderer* b = p->bufs[p->back];
+    renderer_discard(b);
+    return b;
+}
+
+// [Thread produtora] Publica o quadro desenhado desde panel_begin
+void panel_submit(RenderPanel* p) {
+    int antigo = atomic_exchange(&p->ready, p->back | PANEL_NOVO);
+    p->back = antigo & 3;
+}
+
+// [Thread de render] Anexa a 'dst' o quadro mais recente, se houver um novo
+bool panel_collect(RenderPanel* p, Renderer* dst) {
+    if (!(atomic_load(&p->ready) & PANEL_NOVO)) return false;
+    int antigo = atomic_exchange(&p->ready, p->front);
+    p->front = antigo & 3;
+    renderer_append(dst, p->bufs[p->front]);
+    return true;
+}
+
+// [Thread de render] Coleta os painéis em ordem; retorna quantos tinham quadro novo
+int renderer_collect_panels(Renderer* dst, RenderPanel** panels, size_t count) {
+    int novos = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (panel_collect(panels[i], dst)) novos++;
+    }
+    return novos;
+}
+
+// ---------------------------------------------------------------------------
+// Montagem paralela de quadros: a tela é dividida em faixas de linhas, cada faixa
+// é desenhada e comparada com o quadro anterior por um pool de threads, e as faixas
+// alteradas são concatenadas em ordem para um único despejo.
+// ---------------------------------------------------------------------------
+
+// Desenha e compara uma faixa
+static void framepool_run_band(FramePool* pool, int i) {
+    FrameBand* b = &pool->bands[i];
+    Renderer* tmp = b->prev;
+    b->prev = b->cur;
+    b->cur = tmp;
+    renderer_discard(b->cur);
+
+    int y0 = i * pool->band_rows + 1;
+    int y1 = y0 + pool->band_rows - 1;
+    if (y1 > pool->rows) y1 = pool->rows;
+    pool->fn(b->cur, y0, y1, pool->user);
+
+    b->changed = pool->invalid || b->cur->size != b->prev->size ||
+                 memcmp(b->cur->buffer, b->prev->buffer, b->cur->size) != 0;
+}
+
+// Pega faixas até esgotar as do quadro atual
+static void framepool_run_jobs(FramePool* pool) {
+    int i;
+    while ((i = atomic_fetch_add(&pool->next_job, 1)) < pool->band_count) {
+        framepool_run_band(pool, i);
+        if (atomic_fetch_add(&pool->done, 1) + 1 == pool->band_count) {
+            tui_mutex_lock(&pool->lock);
+            tui_cond_broadcast(&pool->cond_done);
+            tui_mutex_unlock(&pool->lock);
+        }
+    }
+}
+
+TUI_THREAD_FN(framepool_worker, arg) {
+    FramePool* pool = (FramePool*)arg;
+    unsigned visto = 0;
+    tui_mutex_lock(&pool->lock);
+    while (true) {
+        while (!pool->quit && visto == pool->generation) tui_cond_wait(&pool->cond_work, &pool->lock);
+        if (pool->quit) break;
+        visto = pool->generation;
+        pool->acked++;
+        pool->active++;
+        tui_mutex_unlock(&pool->lock);
+
+        framepool_run_jobs(pool);
+
+        tui_mutex_lock(&pool->lock);
+        if (--pool->active == 0) tui_cond_broadcast(&pool->cond_done);
+    }
+    tui_mutex_unlock(&pool->lock);
+    return TUI_THREAD_RET;
+}
+
+// Cria o pool com 'threads' auxiliares (<= 0 usa o número de núcleos menos um)
+FramePool* framepool_create(int threads) {
+    FramePool* pool = (FramePool*)calloc(1, sizeof(FramePool));
+    if (!pool) return NULL;
+    if (threads <= 0) threads = tui_cpu_count() - 1;
+
+    tui_mutex_init(&pool->lock);
+    tui_cond_init(&pool->cond_work);
+    tui_cond_init(&pool->cond_done);
+    atomic_init(&pool->next_job, 0);
+    atomic_init(&pool->done, 0);
+    pool->invalid = true;
+
+    pool->threads = (tui_thread*)malloc((threads > 0 ? threads : 1) * sizeof(tui_thread));
+    for (int i = 0; pool->threads && i < threads; i++) {
+        if (!tui_thread_start(&pool->threads[i], framepool_worker, pool)) break;
+        pool->n_threads++;
+    }
+    return pool;
+}
+
+// Libera as faixas do layout atual
+static void framepool_free_bands(FramePool* pool) {
+    for (int i = 0; i < pool->band_count; i++) {
+        renderer_destroy(pool->bands[i].cur);
+        renderer_destroy(pool->bands[i].prev);
+    }
+    free(pool->bands);
+    pool->bands = NULL;
+    pool->band_count = 0;
+}
+
+// Encerra as threads e libera o pool
+void framepool_destroy(FramePool* pool) {
+    if (!pool) return;
+    tui_mutex_lock(&pool->lock);
+    pool->quit = true;
+    tui_cond_broadcast(&pool->cond_work);
+    tui_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->n_threads; i++) tui_thread_join(pool->threads[i]);
+
+    framepool_free_bands(pool);
+    free(pool->threads);
+    tui_cond_destroy(&pool->cond_work);
+    tui_cond_destroy(&pool->cond_done);
+    tui_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+// Força o próximo quadro a emitir todas as faixas (ex.: após limpar a tela)
+void framepool_invalidate(FramePool* pool) {
+    pool->invalid = true;
+}
+
+// Monta um quadro de 'rows' linhas em faixas de 'band_rows' linhas, chamando 'fn' em
+// paralelo para cada faixa, e anexa a 'r' apenas as faixas que mudaram, em ordem.
+// Retorna o número de faixas anexadas (-1 em falha de alocação). O chamador despeja 'r'.
+int frame_build_parallel(FramePool* pool, Renderer* r, int rows, int band_rows, FrameBandFn fn, void* user) {
+    if (rows <= 0) return 0;
+    if (band_rows <= 0) band_rows = 8;
+
+    // Novo layout: recria as faixas e emite tudo
+    if (rows != pool->rows || band_rows != pool->band_rows) {
+        framepool_free_bands(pool);
+        int count = (rows + band_rows - 1) / band_rows;
+        pool->bands = (FrameBand*)calloc(count, sizeof(FrameBand));
+        if (!pool->bands) {
+            pool->rows = 0;
+            return -1;
+        }
+        for (int i = 0; i < count; i++) {
+            pool->bands[i].cur = renderer_create_fd(TUI_FD_INVALID, 1024);
+            pool->bands[i].prev = renderer_create_fd(TUI_FD_INVALID, 1024);
+            pool->band_count = i + 1;
+            if (!pool->bands[i].cur || !pool->bands[i].prev) {
+                framepool_free_bands(pool);
+                pool->rows = 0;
+                return -1;
+            }
+        }
+        pool->rows = rows;
+        pool->band_rows = band_rows;
+        pool->invalid = true;
+    }
+
+    // Publica o trabalho: os campos são escritos antes de liberar os contadores
+    pool->fn = fn;
+    pool->user = user;
+    atomic_store(&pool->done, 0);
+    atomic_store(&pool->next_job, 0);
+
+    tui_mutex_lock(&pool->lock);
+    pool->generation++;
+    pool->acked = 0;
+    tui_cond_broadcast(&pool->cond_work);
+    tui_mutex_unlock(&pool->lock);
+
+    // A thread chamadora também desenha faixas
+    framepool_run_jobs(pool);
+
+    // Espera também os auxiliares que ainda não acordaram: um atrasado leria as faixas
+    // depois que um novo layout as liberasse
+    tui_mutex_lock(&pool->lock);
+    while (atomic_load(&pool->done) < pool->band_count || pool->active > 0 ||
+           pool->acked < pool->n_threads) {
+        tui_cond_wait(&pool->cond_done, &pool->lock);
+    }
+    tui_mutex_unlock(&pool->lock);
+
+    // Concatena em ordem as faixas alteradas
+    int anexadas = 0;
+    for (int i = 0; i < pool->band_count; i++) {
+        if (!pool->bands[i].changed) continue;
+        renderer_append(r, pool->bands[i].cur);
+        anexadas++;
+    }
+    pool->invalid = false;
+    return anexadas;
+}
+#endif // TUI_NO_THREADS
+
+// Inicializa a estrutura de interface e constantes
+Interface* interface_create() {
+    Interface* i = (Interface*)malloc(sizeof(Interface));
+    i->B_RESET = "\033[0m";
+    i->B_SPACE = " ";
+    return i;
+}
+
+// Libera a memória da interface
+void interface_destroy(Interface* i) {
+    if (i) free(i);
+}
+
+// Calcula o comprimento visual da string (ignora ANSI e formatação UTF-8)
+int interface_visible_len(const char* s) {
+    if (!s) return 0;
+    int length = 0;
+    bool in_escape = false;
+    size_t n = strlen(s);
+
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)s[i];
+
+        if (c == 27) { // Início de sequência ANSI
+            in_escape = true;
+        } else if (in_escape) {
+            // Termina sequência ANSI em 'm' ou letras (geralmente)
+            if (c == 'm' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+                in_escape = false;
+            }
+        } else {
+            // Conta apenas bytes iniciais de caracteres UTF-8
+            if ((c & 0xC0) != 0x80) {
+                length++;
+            }
+        }
+    }
+    return length;
+}
+
+// Move o cursor utilizando o buffer do Renderer
+void interface_move_cursor(Renderer* r, int y, int x) {
+    char buffer[32];
+    int len = sprintf(buffer, "\033[%d;%dH", y, x);
+    renderer_add_raw(r, buffer, len);
+}
+
+#ifndef TUI_NO_WORDWRAP
+// Quebra o texto em linhas baseado na largura (Word Wrap)
+char** simple_word_wrap(const char* text, int width, int* num_lines) {
+    int capacity = 16;
+    char** lines = (char**)malloc(capacity * sizeof(char*));
+    *num_lines = 0;
+
+    const char* ptr = text;
+    size_t len = strlen(text);
+    const char* end = text + len;
+
+    while (ptr < end) {
+        // Ignora espaços no início da linha
+        while (ptr < end && *ptr == ' ') ptr++;
+        if (ptr >= end) break;
+
+        const char* line_start = ptr;
+        const char* line_end = line_start;
+        int current_width = 0;
+
+        // Processa palavras até preencher a largura ou encontrar quebra
+        while (ptr < end && *ptr != '\n') {
+            int word_len_visible = 0;
+            const char* word_end = ptr;
+
+            // Calcula tamanho visual da palavra atual
+            while (word_end < end && *word_end != ' ' && *word_end != '\n') {
+                if ((*word_end & 0xC0) != 0x80) word_len_visible++;
+                word_end++;
+            }
+            
+            int spaces = (line_end == line_start) ? 0 : 1;
+            
+            // Verifica se a palavra cabe na linha atual
+            if (current_width + spaces + word_len_visible <= width) {
+                current_width += spaces + word_len_visible;
+                line_end = word_end;
+                ptr = word_end;
+                if (ptr < end && *ptr == ' ') ptr++; 
+            } else {
+                break; // Não cabe, força nova linha
+            }
+        }
+        
+        // Trata caso de palavra única maior que a largura total
+        if (line_end == line_start && ptr < end) {
+             while (ptr < end && *ptr != ' ' && *ptr != '\n' && current_width < width) {
+                ptr++;
+                current_width++;
+             }
+             line_end = ptr;
+        }
+
+        // Aloca e copia a linha finalizada para o array
+        int line_bytes = (int)(line_end - line_start);
+        char* line_str = (char*)malloc(line_bytes + 1);
+        memcpy(line_str, line_start, line_bytes);
+        line_str[line_bytes] = '\0';
+
+        // Expande array de linhas se necessário
+        if (*num_lines >= capacity) {
+            capacity *= 2;
+            lines = (char**)realloc(lines, capacity * sizeof(char*));
+        }
+        lines[*num_lines] = line_str;
+        (*num_lines)++;
+
+        if (ptr < end && *ptr == '\n') ptr++;
+    }
+
+    return lines;
+}
+
+#else
+// Sem quebra por palavras: divide nas quebras manuais (\n) e corta na largura
+char** simple_word_wrap(const char* text, int width, int* num_lines) {
+    int capacity = 16;
+    char** lines = (char**)malloc(capacity * sizeof(char*));
+    *num_lines = 0;
+    if (width < 1) width = 1;
+
+    const char* p = text;
+    while (*p) {
+        const char* start = p;
+        int vis = 0;
+        while (*p && *p != '\n' && (vis < width || (*p & 0xC0) == 0x80)) {
+            if ((*p & 0xC0) != 0x80) vis++;
+            p++;
+        }
+        int n = (int)(p - start);
+        char* line = (char*)malloc(n + 1);
+        memcpy(line, start, n);
+        line[n] = '\0';
+        if (*num_lines >= capacity) {
+            capacity *= 2;
+            lines = (char**)realloc(lines, capacity * sizeof(char*));
+        }
+        lines[(*num_lines)++] = line;
+        if (*p == '\n') p++;
+    }
+    return lines;
+}
+#endif
+
+// Libera a memória da matriz de strings criada pelo word wrap
+void free_wrapped_lines(char** lines, int count) {
+    for (int i = 0; i < count; i++) free(lines[i]);
+    free(lines);
+}
+
+// Preenche uma área retangular com espaços e cor de fundo (limpeza visual)
+void interface_clear(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* bg_color) {
+    if (!bg_color) bg_color = "\033[40m";
+    
+    for (int i = 0; i < height + 2; i++) {
+        interface_move_cursor(r, y + i, x);
+        renderer_add(r, bg_color);
+        renderer_add_repeat(r, " ", width + 2);
+        renderer_add(r, ui->B_RESET);
+    }
+}
+
+// Desenha a caixa com linhas de texto já quebradas (usado por interface_draw e pelo layout)
+void interface_draw_lines(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* title, char** lines, int num_lines, const char* bg_color, const char* border_color, const char* text_color) {
+    // Configurações padrão de cor
+    if (!bg_color) bg_color = "";
+    if (!border_color) border_color = "\033[37m";
+    if (!text_color) text_color = "\033[37m";
+
+    // Caracteres de borda dupla (UTF-8)
+    const char* TL = "\xE2\x95\x94";
+    const char* H  = "\xE2\x95\x90";
+    const char* TR = "\xE2\x95\x97";
+    const char* V  = "\xE2\x95\x91";
+    const char* BL = "\xE2\x95\x9A";
+    const char* BR = "\xE2\x95\x9D";
+
+    // --- 1. Topo da caixa ---
+    interface_move_cursor(r, y, x);
+    renderer_add(r, bg_color);
+    renderer_add(r, border_color);
+    renderer_add(r, TL);
+
+    // Insere título se houver espaço
+    if (title && strlen(title) > 0) {
+        int t_len = interface_visible_len(title);
+        if (t_len + 2 < width) {
+            renderer_add(r, " ");
+            renderer_add_ref(r, title);
+            renderer_add(r, " ");
+            renderer_add_repeat(r, H, width - t_len - 2);
+        } else {
+            renderer_add_ref(r, title);
+        }
+    } else {
+        renderer_add_repeat(r, H, width);
+    }
+    renderer_add(r, TR);
+    renderer_add(r, ui->B_RESET);
+
+    // --- 2. Corpo da caixa ---
+    for (int i = 0; i < height; i++) {
+        interface_move_cursor(r, y + i + 1, x);
+        renderer_add(r, bg_color);
+        renderer_add(r, border_color);
+        renderer_add(r, V);
+        renderer_add(r, text_color);
+
+        int padding = width;
+        if (i < num_lines) {
+            int len = interface_visible_len(lines[i]);
+            if (len > width) {
+                renderer_add(r, lines[i]); 
+                padding = 0;
+            } else {
+                renderer_add(r, lines[i]);
+                padding = width - len;
+            }
+        }
+
+        // Preenche o resto da linha com espaços
+        renderer_add_repeat(r, " ", padding);
+
+        renderer_add(r, border_color);
+        renderer_add(r, V);
+        renderer_add(r, ui->B_RESET);
+    }
+
+    // --- 3. Base da caixa ---
+    interface_move_cursor(r, y + height + 1, x);
+    renderer_add(r, bg_color);
+    renderer_add(r, border_color);
+    renderer_add(r, BL);
+    renderer_add_repeat(r, H, width);
+    renderer_add(r, BR);
+    renderer_add(r, ui->B_RESET);
+}
+
+// Desenha uma caixa com bordas, título e texto estático centralizado
+void interface_draw(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* title, const char* text_line, const char* bg_color, const char* border_color, const char* text_color) {    
+    // Prepara o texto interno
+    int num_lines = 0;
+    char** lines = NULL;
+    if (text_line && strlen(text_line) > 0) {
+        lines = simple_word_wrap(text_line, width, &num_lines); 
+    }
+
+    interface_draw_lines(ui, r, x, y, height, width, title, lines, num_lines, bg_color, border_color, text_color);
+    if (lines) free_wrapped_lines(lines, num_lines);
+}
+
+#ifndef TUI_NO_WIDGETS
+// --- Layout retido: widgets com posição relativa ao terminal, redesenhados só quando mudam ---
+
+Layout* layout_create(Interface* ui, int rows, int cols) {
+    Layout* l = (Layout*)malloc(sizeof(Layout));
+    if (!l) return NULL;
+    l->ui = ui;
+    l->items = NULL;
+    l->count = 0;
+    l->capacity = 0;
+    l->rows = rows;
+    l->cols = cols;
+    return l;
+}
+
+void layout_destroy(Layout* l) {
+    if (!l) return;
+    for (int i = 0; i < l->count; i++) {
+        LayoutItem* it = &l->items[i];
+        free(it->title);
+        free(it->text);
+        if (it->lines) free_wrapped_lines(it->lines, it->num_lines);
+    }
+    free(l->items);
+    free(l);
+}
+
+// Converte uma coordenada da especificação para células
+static int layout_coord(int v, int total) {
+    if (v >= 0) return v;
+    if (v > -1000) return total + v;
+    return total * (-1000 - v) / 100;
+}
+
+// Recalcula o retângulo do item; retorna true se mudou
+static bool layout_resolve(Layout* l, LayoutItem* it) {
+    int x = layout_coord(it->x, l->cols);
+    int y = layout_coord(it->y, l->rows);
+    int w = layout_coord(it->w, l->cols);
+    int h = layout_coord(it->h, l->rows);
+    // Tamanho negativo é a distância da borda final
+    if (it->w < 0 && it->w > -1000) w = w + 1 - x;
+    if (it->h < 0 && it->h > -1000) h = h + 1 - y;
+    // Mantém dentro da tela
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x + w > l->cols) w = l->cols - x;
+    if (y + h > l->rows) h = l->rows - y;
+    if (w < 0) w = 0;
+    if (h < 0) h = 0;
+    bool mudou = x != it->rx || y != it->ry || w != it->rw || h != it->rh;
+    it->rx = x;
+    it->ry = y;
+    it->rw = w;
+    it->rh = h;
+    return mudou;
+}
+
+// Acrescenta um item (NULL em falha de alocação; o layout fica como estava)
+static LayoutItem* layout_push(Layout* l, int x, int y, int w, int h) {
+    if (l->count == l->capacity) {
+        int nova = l->capacity ? l->capacity * 2 : 8;
+        LayoutItem* temp = (LayoutItem*)realloc(l->items, nova * sizeof(LayoutItem));
+        if (!temp) return NULL;
+        l->items = temp;
+        l->capacity = nova;
+    }
+    LayoutItem* it = &l->items[l->count++];
+    memset(it, 0, sizeof(*it));
+    it->x = x;
+    it->y = y;
+    it->w = w;
+    it->h = h;
+    it->wrap_width = -1;
+    it->dirty = true;
+    layout_resolve(l, it);
+    return it;
+}
+
+// Cópia de 's' em 'dst' (NULL copia NULL); false em falha de alocação
+static bool layout_strdup(char** dst, const char* s) {
+    *dst = NULL;
+    if (!s) return true;
+    size_t n = strlen(s) + 1;
+    *dst = (char*)malloc(n);
+    if (!*dst) return false;
+    memcpy(*dst, s, n);
+    return true;
+}
+
+// Adiciona uma caixa com título e texto; retorna o índice do item (-1 em falha de alocação)
+int layout_add_box(Layout* l, int x, int y, int w, int h, const char* title, const char* text, const char* bg_color, const char* border_color, const char* text_color) {
+    char* titulo;
+    char* texto;
+    if (!layout_strdup(&titulo, title)) return -1;
+    if (!layout_strdup(&texto, text)) {
+        free(titulo);
+        return -1;
+    }
+    LayoutItem* it = layout_push(l, x, y, w, h);
+    if (!it) {
+        free(titulo);
+        free(texto);
+        return -1;
+    }
+    it->title = titulo;
+    it->text = texto;
+    it->bg_color = bg_color;
+    it->border_color = border_color;
+    it->text_color = text_color;
+    return l->count - 1;
+}
+
+// Adiciona um widget desenhado por 'fn' dentro do retângulo resolvido (-1 em falha de alocação)
+int layout_add_custom(Layout* l, int x, int y, int w, int h, LayoutDrawFn fn, void* user) {
+    LayoutItem* it = layout_push(l, x, y, w, h);
+    if (!it) return -1;
+    it->draw = fn;
+    it->user = user;
+    return l->count - 1;
+}
+
+// Troca o texto de uma caixa; só ela será redesenhada. Retorna 0, ou -1 em falha de
+// alocação (o texto anterior é mantido).
+int layout_set_text(Layout* l, int id, const char* text) {
+    LayoutItem* it = &l->items[id];
+    char* novo;
+    if (!layout_strdup(&novo, text)) return -1;
+    free(it->text);
+    it->text = novo;
+    if (it->lines) free_wrapped_lines(it->lines, it->num_lines);
+    it->lines = NULL;
+    it->num_lines = 0;
+    it->wrap_width = -1;
+    it->dirty = true;
+    return 0;
+}
+
+// Marca um item (ou todos, com id < 0) para redesenho
+void layout_invalidate(Layout* l, int id) {
+    if (id >= 0) {
+        l->items[id].dirty = true;
+        return;
+    }
+    for (int i = 0; i < l->count; i++) l->items[i].dirty = true;
+}
+
+static bool layout_overlap(const LayoutItem* a, int x, int y, int w, int h) {
+    return a->rx < x + w && x < a->rx + a->rw && a->ry < y + h && y < a->ry + a->rh;
+}
+
+// Ajusta o layout ao novo tamanho do terminal: limpa a área antiga só dos itens que
+// mudaram de lugar/tamanho e marca para redesenho esses e os que se sobrepõem a eles
+void layout_resize(Layout* l, Renderer* r, int rows, int cols) {
+    if (rows == l->rows && cols == l->cols) return;
+    l->rows = rows;
+    l->cols = cols;
+    for (int i = 0; i < l->count; i++) {
+        LayoutItem* it = &l->items[i];
+        int ox = it->rx, oy = it->ry, ow = it->rw, oh = it->rh;
+        if (!layout_resolve(l, it)) continue;
+        it->dirty = true;
+
+        // Apaga o que ficou do retângulo antigo (dentro da nova tela)
+        if (ox + ow > cols) ow = cols - ox;
+        if (oy + oh > rows) oh = rows - oy;
+        if (ow > 0 && oh > 0) {
+            for (int j = 0; j < oh; j++) {
+                interface_move_cursor(r, oy + j + 1, ox + 1);
+                renderer_add_repeat(r, " ", ow);
+            }
+            for (int k = 0; k < l->count; k++) {
+                if (layout_overlap(&l->items[k], ox, oy, ow, oh)) l->items[k].dirty = true;
+            }
+        }
+    }
+}
+
+// Redesenha apenas os itens marcados; o texto só é requebrado se a largura interna mudou
+void layout_draw(Layout* l, Renderer* r) {
+    for (int i = 0; i < l->count; i++) {
+        LayoutItem* it = &l->items[i];
+        if (!it->dirty) continue;
+        it->dirty = false;
+        if (it->rw <= 0 || it->rh <= 0) continue;
+
+        if (it->draw) {
+            it->draw(r, it->rx + 1, it->ry + 1, it->rh, it->rw, it->user);
+            continue;
+        }
+        // Caixa precisa de bordas dos dois lados
+        if (it->rw < 2 || it->rh < 2) continue;
+        int inner = it->rw - 2;
+        if (it->text && inner > 0 && inner != it->wrap_width) {
+            if (it->lines) free_wrapped_lines(it->lines, it->num_lines);
+            it->num_lines = 0;
+            it->lines = simple_word_wrap(it->text, inner, &it->num_lines);
+            it->wrap_width = inner;
+        }
+        interface_draw_lines(l->ui, r, it->rx + 1, it->ry + 1, it->rh - 2, inner, it->title, it->lines, it->num_lines, it->bg_color, it->border_color, it->text_color);
+    }
+}
+
+#endif // TUI_NO_WIDGETS
+
+// Auxiliar para detectar bytes de caractere UTF-8
+int get_utf8_char_len(unsigned char c) {
+    if ((c & 0x80) == 0) return 1;        // ASCII (1 byte)
+    if ((c & 0xE0) == 0xC0) return 2;     // 2 bytes
+    if ((c & 0xF0) == 0xE0) return 3;     // 3 bytes
+    if ((c & 0xF8) == 0xF0) return 4;     // 4 bytes
+    return 1; // Fallback
+}
+
+#ifndef TUI_NO_ANIMATION
+// Caixa de diálogo estilo RPG: digitação letra por letra, paginação e skip
+void interface_drawspeak(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* title, const char* texto, const char* bg_color, const char* border_color, const char* text_color, float speed) {
+    
+    if (!bg_color) bg_color = "\033[40m";
+    if (!text_color) text_color = "\033[37m";
+
+    // Quebra todo o texto antes de começar
+    int total_lines = 0;
+    char** wrapped_lines = simple_word_wrap(texto, width, &total_lines);
+    
+    unsigned sleep_ms = (unsigned)(speed * 1000);
+    bool pular_animacao = false;
+
+    // Loop de paginação (pula de 'height' em 'height' linhas)
+    for (int i = 0; i < total_lines; i += height) {
+        pular_animacao = false;
+        
+        // Desenha a moldura vazia
+        interface_draw(ui, r, x, y, height, width, title, "", bg_color, border_color, text_color);
+        renderer_render(r);
+        
+        int lines_in_page = (total_lines - i) > height ? height : (total_lines - i);
+
+        // Processa cada linha da página atual
+        for (int l = 0; l < lines_in_page; l++) {
+            char* line = wrapped_lines[i + l];
+            int pos_y = y + 1 + l;
+            int pos_x = x + 1;
+
+            // Se usuário pulou, imprime a linha inteira de uma vez
+            if (pular_animacao) {
+                interface_move_cursor(r, pos_y, pos_x);
+                renderer_add(r, bg_color);
+                renderer_add(r, text_color);
+                renderer_add(r, line);
+                renderer_render(r);
+                continue;
+            }
+            
+            // Efeito de digitação caractere por caractere
+            size_t len = strlen(line);
+            for (size_t k = 0; k < len; ) {
+                interface_move_cursor(r, pos_y, pos_x);
+                renderer_add(r, bg_color);
+                renderer_add(r, text_color);
+                
+                unsigned char c = (unsigned char)line[k];
+                int char_bytes = get_utf8_char_len(c);
+                
+                renderer_add_raw(r, &line[k], char_bytes);
+                renderer_render(r); // Renderiza imediatamente
+
+                k += char_bytes;
+                pos_x++; 
+
+                tui_sleep_ms(sleep_ms);
+
+                // Detecta tecla para pular animação
+                if (inputs_get_key() != 0) {
+                    pular_animacao = true;
+                    // Completa o restante da linha atual
+                    if (k < len) {
+                        renderer_add(r, &line[k]); 
+                        renderer_render(r);
+                    }
+                    break; 
+                }
+            }
+        }
+
+        // Indicador de "Próxima Página" (seta para baixo)
+        interface_move_cursor(r, y + height, x + width);
+        renderer_add(r, bg_color);
+        renderer_add(r, border_color);
+        renderer_add(r, "\xE2\x96\xBC"); 
+        renderer_add(r, ui->B_RESET);
+        renderer_render(r);
+
+        // Espera interação do usuário (Enter, Espaço ou Z)
+        while (true) {
+            tui_sleep_ms(50);
+            int key = inputs_get_key();
+            if (key == 13 || key == 32 || key == 'z' || key == 'Z') break;
+        }
+    }
+
+    free_wrapped_lines(wrapped_lines, total_lines);
+}
+
+#endif
+
+// Variante de interface_draw (estrutura quase idêntica)
+void interface_drawline(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* title, const char* text_line, const char* bg_color, const char* border_color, const char* text_color, const char* border_style) {
+    if (!bg_color) bg_color = "";
+    if (!border_color) border_color = "\033[37m";
+    if (!text_color) text_color = "\033[37m";
+    
+    const char* TL = "\xE2\x95\x94"; const char* H  = "\xE2\x95\x90";
+    const char* TR = "\xE2\x95\x97"; const char* V  = "\xE2\x95\x91";
+    const char* BL = "\xE2\x95\x9A"; const char* BR = "\xE2\x95\x9D";
+    
+    int total_lines = 0;
+    char** lines = NULL;
+    if (text_line && *text_line) {
+        lines = simple_word_wrap(text_line, width, &total_lines);
+    }
+
+    // Topo
+    interface_move_cursor(r, y, x);
+    renderer_add(r, bg_color);
+    renderer_add(r, border_color);
+    renderer_add(r, TL);
+
+    if (title && *title) {
+        int t_len = interface_visible_len(title);
+        if (t_len + 2 < width) {
+            renderer_add(r, " ");
+            renderer_add_ref(r, title);
+            renderer_add(r, " ");
+            renderer_add_repeat(r, H, width - t_len - 2);
+        } else {
+            renderer_add_ref(r, title);
+        }
+    } else {
+        renderer_add_repeat(r, H, width);
+    }
+    renderer_add(r, TR);
+    renderer_add(r, ui->B_RESET);
+
+    // Corpo
+    for (int i = 0; i < height; i++) {
+        interface_move_cursor(r, y + i + 1, x);
+        renderer_add(r, bg_color);
+        renderer_add(r, border_color);
+        renderer_add(r, V);
+        renderer_add(r, text_color);
+
+        int padding = width;
+        if (i < total_lines) {
+            int len = interface_visible_len(lines[i]);
+            if (len > width) {
+                 renderer_add(r, lines[i]);
+                 padding = 0;
+            } else {
+                renderer_add(r, lines[i]);
+                padding = width - len;
+            }
+        }
+
+        renderer_add_repeat(r, " ", padding);
+        renderer_add(r, border_color);
+        renderer_add(r, V);
+        renderer_add(r, ui->B_RESET);
+    }
+    
+    // Base
+    interface_move_cursor(r, y + height + 1, x);
+    renderer_add(r, bg_color);
+    renderer_add(r, border_color);
+    renderer_add(r, BL);
+    renderer_add_repeat(r, H, width);
+    renderer_add(r, BR);
+    renderer_add(r, ui->B_RESET);
+    
+    if (lines) free_wrapped_lines(lines, total_lines);
+}
+
+#ifndef TUI_NO_ANIMATION
+// Escreve texto solto na tela com efeito de digitação (sem moldura)
+void interface_text_speak(Interface* ui, Renderer* r, int x, int y, const char* texto, const char* bg_color, const char* text_color, float speed) {
+    
+    if (!bg_color) bg_color = "\033[40m";
+    if (!text_color) text_color = "\033[37m";
+    
+    unsigned sleep_ms = (unsigned)(speed * 1000);
+    bool pular = false;
+    size_t n = strlen(texto);
     
     interface_move_cursor(r, y, x);
     renderer_add(r, bg_color);
@@ -548,177 +2301,2058 @@ void interface_text_speak(Interface* ui, Renderer* r, int x, int y, const char*
             renderer_add(r, bg_color);
             renderer_add(r, text_color);
             renderer_render(r);
-            i++;
+            i++;
+            continue;
+        }
+        
+        int char_len = get_utf8_char_len(c);
+        renderer_add_raw(r, (char*)&texto[i], char_len);
+        renderer_render(r); // Flush obrigatório para animação
+        
+        i += char_len;
+        
+        if (!pular) {
+            if (inputs_get_key() != 0) {
+                pular = true;
+            } else {
+                tui_sleep_ms(sleep_ms);
+            }
+        }
+    }
+    renderer_add(r, ui->B_RESET);
+    renderer_render(r);
+}
+
+#endif
+
+// Imprime texto estático respeitando quebras de linha manuais (\n)
+void interface_text_(Interface* ui, Renderer* r, int x, int y, const char* texto, const char* text_color, const char* bg_color) {
+    
+    if (!bg_color) bg_color = "";
+    if (!text_color) text_color = "";
+    
+    const char* start = texto;
+    const char* end;
+    int current_y = y;
+
+    // Itera sobre as linhas separadas por \n
+    while ((end = strchr(start, '\n')) != NULL) {
+        int len = (int)(end - start);        
+        interface_move_cursor(r, current_y, x);
+        if (*bg_color) renderer_add(r, bg_color);
+        if (*text_color) renderer_add(r, text_color);
+        renderer_add_ref_raw(r, start, len);
+        renderer_add(r, ui->B_RESET);
+        
+        start = end + 1;
+        current_y++;
+    }
+    
+    // Imprime o último pedaço (ou a string inteira se não houver \n)
+    if (*start) {
+        interface_move_cursor(r, current_y, x);
+        if (*bg_color) renderer_add(r, bg_color);
+        if (*text_color) renderer_add(r, text_color);
+        renderer_add_ref(r, start);
+        renderer_add(r, ui->B_RESET);
+    }
+}
+
+#ifndef TUI_NO_WIDGETS
+// --- Tabela: colunas fixas/automáticas, visão ordenada e redesenho por linha ---
+
+#define TABLE_ROW_DIRTY 1   // Conteúdo mudou desde o último desenho
+#define TABLE_ROW_MOVE 2    // Aguardando reinserção na visão ordenada
+#define TABLE_ROW_NUM 4     // A célula da coluna de ordenação é numérica (valor em keys)
+
+Table* table_create(int ncols) {
+    Table* t = (Table*)calloc(1, sizeof(Table));
+    if (!t) return NULL;
+    t->cols = (TableColumn*)calloc(ncols, sizeof(TableColumn));
+    if (!t->cols) {
+        free(t);
+        return NULL;
+    }
+    t->ncols = ncols;
+    for (int c = 0; c < ncols; c++) {
+        t->cols[c].auto_width = true;
+        t->cols[c].max_width = 40;
+    }
+    t->sort_col = -1;
+    t->header_dirty = true;
+    t->header_color = C_BOLD;
+    t->text_color = "";
+    return t;
+}
+
+void table_destroy(Table* t) {
+    if (!t) return;
+    for (int c = 0; c < t->ncols; c++) free(t->cols[c].title);
+    for (long i = 0; i < (long)t->rows * t->ncols; i++) free(t->cells[i]);
+    free(t->cols);
+    free(t->cells);
+    free(t->flags);
+    free(t->keys);
+    free(t->order);
+    free(t->tmp);
+    free(t->pending);
+    free(t->drawn);
+    free(t);
+}
+
+// Marca toda a janela para redesenho
+void table_invalidate(Table* t) {
+    t->header_dirty = true;
+    for (int i = 0; t->drawn && i < t->height - 1; i++) t->drawn[i] = -3;
+}
+
+// Largura visual em code points (sem ANSI dentro das células)
+static int table_text_width(const char* s) {
+    int n = 0;
+    for (; s && *s; s++) if ((*s & 0xC0) != 0x80) n++;
+    return n;
+}
+
+// Amplia uma coluna automática para caber 'w' colunas
+static void table_fit(Table* t, int col, int w) {
+    TableColumn* c = &t->cols[col];
+    if (!c->auto_width || w <= c->width) return;
+    int nova = w < c->max_width ? w : c->max_width;
+    if (nova == c->width) return;
+    c->width = nova;
+    table_invalidate(t);
+}
+
+// Define título, largura (0 = automática até max_width) e alinhamento de uma coluna
+void table_set_column(Table* t, int col, const char* title, int width, int max_width, int align) {
+    TableColumn* c = &t->cols[col];
+    free(c->title);
+    c->title = NULL;
+    if (title) {
+        size_t n = strlen(title) + 1;
+        c->title = (char*)malloc(n);
+        if (c->title) memcpy(c->title, title, n);  // Sem memória: coluna sem título
+    }
+    c->auto_width = width <= 0;
+    c->max_width = max_width > 0 ? max_width : 40;
+    c->width = c->auto_width ? 0 : width;
+    c->align = align;
+    table_invalidate(t);
+    table_fit(t, col, table_text_width(title));
+}
+
+// Define a janela na tela; height inclui a linha de cabeçalho
+void table_set_view(Table* t, int x, int y, int height, int width) {
+    if (height < 1) height = 1;
+    if (height != t->height || !t->drawn) {
+        free(t->drawn);
+        t->drawn = (int*)malloc(height * sizeof(int));
+    }
+    t->x = x;
+    t->y = y;
+    t->height = height;
+    t->width = width;
+    table_invalidate(t);
+}
+
+// Rola a janela para mostrar a partir da posição 'top' e da coluna 'first_col'.
+// Linhas que continuam na tela não são reenviadas se a coluna inicial não mudou.
+void table_scroll(Table* t, int top, int first_col) {
+    if (top < 0) top = 0;
+    if (first_col < 0) first_col = 0;
+    if (first_col >= t->ncols) first_col = t->ncols - 1;
+    t->top = top;
+    if (first_col != t->first_col) {
+        t->first_col = first_col;
+        table_invalidate(t);
+    }
+}
+
+void table_set_colors(Table* t, const char* header_color, const char* text_color) {
+    t->header_color = header_color ? header_color : "";
+    t->text_color = text_color ? text_color : "";
+    table_invalidate(t);
+}
+
+// Converte a célula da coluna de ordenação uma única vez por alteração
+static void table_key(Table* t, int row) {
+    const char* s = t->cells[(long)row * t->ncols + t->sort_col];
+    char* fim;
+    double v = s ? strtod(s, &fim) : 0;
+    t->flags[row] &= ~TABLE_ROW_NUM;
+    if (s && fim != s && *fim == '\0' && v == v) { // NaN não tem ordem
+        t->keys[row] = v;
+        t->flags[row] |= TABLE_ROW_NUM;
+    }
+}
+
+// Compara duas linhas pela coluna de ordenação: números vêm antes do texto, e cada
+// grupo é ordenado entre si (numérico ou strcmp), para a ordem ser total
+static int table_compare(const Table* t, int a, int b) {
+    if (t->sort_col >= 0) {
+        int r;
+        int na = t->flags[a] & TABLE_ROW_NUM, nb = t->flags[b] & TABLE_ROW_NUM;
+        if (na != nb) {
+            r = na ? -1 : 1;
+        } else if (na) {
+            double da = t->keys[a], db = t->keys[b];
+            r = (da > db) - (da < db);
+        } else {
+            const char* sa = t->cells[(long)a * t->ncols + t->sort_col];
+            const char* sb = t->cells[(long)b * t->ncols + t->sort_col];
+            r = strcmp(sa ? sa : "", sb ? sb : "");
+        }
+        if (r != 0) return t->sort_desc ? -r : r;
+    }
+    return (a > b) - (a < b); // Desempate estável pela ordem de inserção
+}
+
+static _Thread_local const Table* table_sort_ctx;
+static int table_qsort_cmp(const void* a, const void* b) {
+    return table_compare(table_sort_ctx, *(const int*)a, *(const int*)b);
+}
+
+// Reinsere em lote as linhas pendentes: remove-as da visão (O(n)), ordena as k
+// pendentes e as intercala por busca binária (O(n + k log n) no total)
+static void table_sync(Table* t) {
+    if (t->pending_count == 0) return;
+    int m = 0;
+    for (int p = 0; p < t->ordered; p++) {
+        int row = t->order[p];
+        if (!(t->flags[row] & TABLE_ROW_MOVE)) t->order[m++] = row;
+    }
+    table_sort_ctx = t;
+    qsort(t->pending, t->pending_count, sizeof(int), table_qsort_cmp);
+
+    int n = 0, de = 0;
+    for (int j = 0; j < t->pending_count; j++) {
+        int row = t->pending[j];
+        int lo = de, hi = m;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (table_compare(t, t->order[mid], row) < 0) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo > de) memcpy(t->tmp + n, t->order + de, (lo - de) * sizeof(int));
+        n += lo - de;
+        de = lo;
+        t->tmp[n++] = row;
+        t->flags[row] &= ~TABLE_ROW_MOVE;
+    }
+    if (m > de) memcpy(t->tmp + n, t->order + de, (m - de) * sizeof(int));
+    n += m - de;
+
+    int* troca = t->order;
+    t->order = t->tmp;
+    t->tmp = troca;
+    t->ordered = n;
+    t->pending_count = 0;
+}
+
+// Agenda a reinserção de uma linha na visão ordenada
+static void table_queue(Table* t, int row) {
+    if (t->flags[row] & TABLE_ROW_MOVE) return;
+    t->flags[row] |= TABLE_ROW_MOVE;
+    t->pending[t->pending_count++] = row;
+}
+
+// Guarda o texto da célula; false em falha de alocação (a célula fica como estava)
+static bool table_store(Table* t, int row, int col, const char* text) {
+    char** cell = &t->cells[(long)row * t->ncols + col];
+    size_t n = text ? strlen(text) : 0;
+    if (*cell && strlen(*cell) >= n) {
+        memcpy(*cell, text ? text : "", n + 1); // Reaproveita a memória da célula
+    } else {
+        char* novo = (char*)malloc(n + 1);
+        if (!novo) return false;
+        free(*cell);
+        *cell = novo;
+        memcpy(*cell, text ? text : "", n + 1);
+    }
+    table_fit(t, col, table_text_width(text));
+    return true;
+}
+
+// Realoca um vetor da tabela sem perdê-lo em caso de falha
+static bool table_grow(void** p, size_t bytes) {
+    void* temp = realloc(*p, bytes);
+    if (!temp) return false;
+    *p = temp;
+    return true;
+}
+
+// Adiciona uma linha (ncols textos, NULL = vazio); retorna o identificador da linha
+// ou -1 em falha de alocação (a tabela fica como estava)
+int table_append(Table* t, const char* const* cells) {
+    if (t->rows == t->capacity) {
+        // Vetores que já cresceram ficam maiores; a capacidade só muda se todos cresceram
+        size_t nova = t->capacity ? (size_t)t->capacity * 2 : 256;
+        if (!table_grow((void**)&t->cells, nova * t->ncols * sizeof(char*)) ||
+            !table_grow((void**)&t->flags, nova) ||
+            !table_grow((void**)&t->keys, nova * sizeof(double)) ||
+            !table_grow((void**)&t->order, nova * sizeof(int)) ||
+            !table_grow((void**)&t->tmp, nova * sizeof(int)) ||
+            !table_grow((void**)&t->pending, nova * sizeof(int))) return -1;
+        t->capacity = (int)nova;
+    }
+    int row = t->rows;
+    memset(&t->cells[(long)row * t->ncols], 0, t->ncols * sizeof(char*));
+    for (int c = 0; c < t->ncols; c++) {
+        if (cells && cells[c] && !table_store(t, row, c, cells[c])) {
+            for (int k = 0; k < c; k++) free(t->cells[(long)row * t->ncols + k]);
+            return -1;
+        }
+    }
+    t->rows++;
+    t->flags[row] = TABLE_ROW_DIRTY;
+    if (t->sort_col < 0) {
+        t->order[t->ordered++] = row;
+    } else {
+        table_key(t, row);
+        table_queue(t, row);
+    }
+    return row;
+}
+
+// Troca o texto de uma célula; só a linha (e as que ela deslocar na ordenação) é redesenhada.
+// Retorna 0, ou -1 em falha de alocação (o texto anterior é mantido).
+int table_set_cell(Table* t, int row, int col, const char* text) {
+    const char* atual = t->cells[(long)row * t->ncols + col];
+    if (atual && text && strcmp(atual, text) == 0) return 0;
+    if (!table_store(t, row, col, text)) return -1;
+    t->flags[row] |= TABLE_ROW_DIRTY;
+    if (col == t->sort_col) {
+        table_key(t, row);
+        table_queue(t, row);
+    }
+    return 0;
+}
+
+const char* table_get_cell(const Table* t, int row, int col) {
+    const char* s = t->cells[(long)row * t->ncols + col];
+    return s ? s : "";
+}
+
+int table_row_count(const Table* t) {
+    return t->rows;
+}
+
+// Linha exibida na posição 'p' da visão ordenada
+int table_row_at(Table* t, int p) {
+    table_sync(t);
+    return t->order[p];
+}
+
+// Ordena a visão por 'col' (-1 = ordem de inserção); células numéricas vêm antes das de texto
+void table_sort(Table* t, int col, bool descending) {
+    for (int j = 0; j < t->pending_count; j++) t->flags[t->pending[j]] &= ~TABLE_ROW_MOVE;
+    t->pending_count = 0;
+    t->sort_col = col;
+    t->sort_desc = descending;
+    for (int row = 0; row < t->rows; row++) t->order[row] = row;
+    t->ordered = t->rows;
+    if (col >= 0 && t->rows > 0) {
+        for (int row = 0; row < t->rows; row++) table_key(t, row);
+        table_sort_ctx = t;
+        qsort(t->order, t->rows, sizeof(int), table_qsort_cmp);
+    }
+}
+
+// Escreve 'text' em exatamente 'width' colunas: truncado com reticências ou completado com espaços
+static void table_put(Renderer* r, const char* text, int width, int align) {
+    if (width <= 0) return;
+    if (!text) text = "";
+    int vis = 0;
+    const char* corte = text;   // Fim dos primeiros width-1 caracteres
+    const char* p = text;
+    while (*p) {
+        if ((*p & 0xC0) != 0x80) {
+            if (vis == width - 1) corte = p;
+            vis++;
+            if (vis > width) break;
+        }
+        p++;
+    }
+    if (vis > width) {
+        renderer_add_raw(r, text, corte - text);
+        renderer_add(r, "\xE2\x80\xA6");
+        return;
+    }
+    if (align == TABLE_RIGHT) renderer_add_repeat(r, " ", width - vis);
+    renderer_add_raw(r, text, p - text);
+    if (align != TABLE_RIGHT) renderer_add_repeat(r, " ", width - vis);
+}
+
+// Desenha uma linha da janela (row -1 = cabeçalho, -2 = vazia), materializando só as colunas visíveis
+static void table_draw_line(Table* t, Renderer* r, int screen_y, int row, const char* color) {
+    interface_move_cursor(r, screen_y, t->x);
+    if (*color) renderer_add(r, color);
+    int usado = 0;
+    if (row != -2) {
+        for (int c = t->first_col; c < t->ncols && usado < t->width; c++) {
+            if (c > t->first_col) {
+                renderer_add(r, " ");
+                usado++;
+                if (usado >= t->width) break;
+            }
+            int w = t->cols[c].width;
+            if (w > t->width - usado) w = t->width - usado;
+            const char* s = row < 0 ? t->cols[c].title : t->cells[(long)row * t->ncols + c];
+            table_put(r, s, w, t->cols[c].align);
+            usado += w;
+        }
+    }
+    renderer_add_repeat(r, " ", t->width - usado);
+    if (*color) renderer_add(r, C_RESET);
+}
+
+// Redesenha o cabeçalho se preciso e só as linhas da janela cuja linha exibida
+// mudou de lugar ou de conteúdo desde o último desenho
+void table_draw(Table* t, Renderer* r) {
+    if (!t->drawn) return; // table_set_view ainda não chamado
+    table_sync(t);
+    if (t->header_dirty) {
+        table_draw_line(t, r, t->y, -1, t->header_color);
+        t->header_dirty = false;
+    }
+    for (int i = 0; i < t->height - 1; i++) {
+        int p = t->top + i;
+        int row = p < t->ordered ? t->order[p] : -2;
+        if (row == t->drawn[i] && (row < 0 || !(t->flags[row] & TABLE_ROW_DIRTY))) continue;
+        table_draw_line(t, r, t->y + 1 + i, row, t->text_color);
+        t->drawn[i] = row;
+    }
+    // Limpa a marca só depois: a mesma linha pode ter mudado de posição na janela
+    for (int i = 0; i < t->height - 1; i++) {
+        if (t->drawn[i] >= 0) t->flags[t->drawn[i]] &= ~TABLE_ROW_DIRTY;
+    }
+}
+
+// --- Séries e gráficos com blocos de oitavos (sparkline, barras, medidor) ---
+
+Series* series_create(int capacity) {
+    Series* s = (Series*)malloc(sizeof(Series));
+    if (!s) return NULL;
+    if (capacity < 1) capacity = 1;
+    s->data = (double*)malloc(capacity * sizeof(double));
+    if (!s->data) {
+        free(s);
+        return NULL;
+    }
+    s->capacity = capacity;
+    s->head = 0;
+    s->count = 0;
+    return s;
+}
+
+void series_destroy(Series* s) {
+    if (!s) return;
+    free(s->data);
+    free(s);
+}
+
+void series_push(Series* s, double v) {
+    s->data[s->head] = v;
+    s->head = (s->head + 1) % s->capacity;
+    if (s->count < s->capacity) s->count++;
+}
+
+// Amostra 'i' (0 = mais antiga ainda guardada)
+double series_at(const Series* s, int i) {
+    int p = s->head - s->count + i;
+    if (p < 0) p += s->capacity;
+    return s->data[p];
+}
+
+// Oitavos verticais (barras) e horizontais (medidor); índice = oitavos preenchidos
+static const char* const BLOCO_V[9] = {
+    " ", "\xE2\x96\x81", "\xE2\x96\x82", "\xE2\x96\x83", "\xE2\x96\x84",
+    "\xE2\x96\x85", "\xE2\x96\x86", "\xE2\x96\x87", "\xE2\x96\x88"
+};
+static const char* const BLOCO_H[9] = {
+    " ", "\xE2\x96\x8F", "\xE2\x96\x8E", "\xE2\x96\x8D", "\xE2\x96\x8C",
+    "\xE2\x96\x8B", "\xE2\x96\x8A", "\xE2\x96\x89", "\xE2\x96\x88"
+};
+
+#define BLOCO_DESCONHECIDO 255  // Célula nunca desenhada
+
+// Envia só as células de uma linha cujo nível mudou; trechos separados por
+// poucas células iguais são unidos (reenviar é mais barato que mover o cursor)
+static void blocks_emit_row(Renderer* r, int y, int x, const unsigned char* novo, unsigned char* shown, int n, const char* const* glyphs, const char* color) {
+    int i = 0;
+    while (i < n) {
+        if (novo[i] == shown[i]) {
+            i++;
+            continue;
+        }
+        int fim = i + 1, ultimo = i;
+        while (fim < n && fim - ultimo <= 4) {
+            if (novo[fim] != shown[fim]) ultimo = fim;
+            fim++;
+        }
+        interface_move_cursor(r, y, x + i);
+        if (*color) renderer_add(r, color);
+        for (int k = i; k <= ultimo; k++) {
+            renderer_add(r, glyphs[novo[k]]);
+            shown[k] = novo[k];
+        }
+        if (*color) renderer_add(r, C_RESET);
+        i = ultimo + 1;
+    }
+}
+
+Chart* chart_create(const Series* s, int x, int y, int width, int height) {
+    Chart* c = (Chart*)malloc(sizeof(Chart));
+    if (!c) return NULL;
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    c->series = s;
+    c->x = x;
+    c->y = y;
+    c->width = width;
+    c->height = height;
+    c->bar_width = 1;
+    c->gap = 0;
+    c->min = 0;
+    c->max = 0;
+    c->color = "";
+    c->shown = (unsigned char*)malloc((size_t)width * height);
+    c->next = (unsigned char*)malloc(width);
+    if (!c->shown || !c->next) {
+        chart_destroy(c);
+        return NULL;
+    }
+    memset(c->shown, BLOCO_DESCONHECIDO, (size_t)width * height);
+    return c;
+}
+
+void chart_destroy(Chart* c) {
+    if (!c) return;
+    free(c->shown);
+    free(c->next);
+    free(c);
+}
+
+// Força o redesenho completo (ex.: após limpar a tela)
+void chart_invalidate(Chart* c) {
+    memset(c->shown, BLOCO_DESCONHECIDO, (size_t)c->width * c->height);
+}
+
+void chart_set_range(Chart* c, double min, double max) {
+    c->min = min;
+    c->max = max;
+}
+
+void chart_set_bars(Chart* c, int bar_width, int gap) {
+    c->bar_width = bar_width < 1 ? 1 : bar_width;
+    c->gap = gap < 0 ? 0 : gap;
+    chart_invalidate(c);
+}
+
+void chart_set_color(Chart* c, const char* color) {
+    c->color = color ? color : "";
+    chart_invalidate(c);
+}
+
+// Desenha as últimas amostras que cabem na largura, alinhadas à direita
+void chart_draw(Chart* c, Renderer* r) {
+    int passo = c->bar_width + c->gap;
+    int barras = (c->width + c->gap) / passo;
+    int n = c->series->count < barras ? c->series->count : barras;
+    int base = c->series->count - n;
+
+    double lo = c->min, hi = c->max;
+    if (lo == hi && n > 0) {
+        lo = hi = series_at(c->series, base);
+        for (int i = 1; i < n; i++) {
+            double v = series_at(c->series, base + i);
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+        }
+        if (lo > 0) lo = 0; // Barras partem do zero quando tudo é positivo
+    }
+    double escala = hi > lo ? (double)(c->height * 8) / (hi - lo) : 0;
+
+    // Oitavos preenchidos por barra, da esquerda para a direita
+    int vazio = barras - n;
+    for (int row = 0; row < c->height; row++) {
+        int piso = (c->height - 1 - row) * 8; // Oitavos abaixo desta linha
+        memset(c->next, 0, c->width);
+        for (int b = vazio; b < barras; b++) {
+            double v = series_at(c->series, base + b - vazio);
+            int nivel = (int)((v - lo) * escala + 0.5);
+            if (nivel < 0) nivel = 0;
+            if (nivel > c->height * 8) nivel = c->height * 8;
+            int cel = nivel - piso;
+            if (cel < 0) cel = 0;
+            if (cel > 8) cel = 8;
+            int x0 = c->width - (barras - b) * passo + c->gap;
+            if (x0 < 0) x0 = 0;
+            for (int k = 0; k < c->bar_width && x0 + k < c->width; k++) c->next[x0 + k] = (unsigned char)cel;
+        }
+        blocks_emit_row(r, c->y + row, c->x, c->next, c->shown + (size_t)row * c->width, c->width, BLOCO_V, c->color);
+    }
+}
+
+Gauge* gauge_create(int x, int y, int width, double min, double max) {
+    Gauge* g = (Gauge*)malloc(sizeof(Gauge));
+    if (!g) return NULL;
+    if (width < 1) width = 1;
+    g->x = x;
+    g->y = y;
+    g->width = width;
+    g->min = min;
+    g->max = max;
+    g->value = min;
+    g->color = "";
+    g->shown = (unsigned char*)malloc(width);
+    g->next = (unsigned char*)malloc(width);
+    if (!g->shown || !g->next) {
+        gauge_destroy(g);
+        return NULL;
+    }
+    memset(g->shown, BLOCO_DESCONHECIDO, width);
+    return g;
+}
+
+void gauge_destroy(Gauge* g) {
+    if (!g) return;
+    free(g->shown);
+    free(g->next);
+    free(g);
+}
+
+void gauge_invalidate(Gauge* g) {
+    memset(g->shown, BLOCO_DESCONHECIDO, g->width);
+}
+
+void gauge_set_color(Gauge* g, const char* color) {
+    g->color = color ? color : "";
+    gauge_invalidate(g);
+}
+
+void gauge_set(Gauge* g, double v) {
+    g->value = v;
+}
+
+// Redesenha apenas as células da borda da barra que mudaram
+void gauge_draw(Gauge* g, Renderer* r) {
+    double f = g->max > g->min ? (g->value - g->min) / (g->max - g->min) : 0;
+    if (f < 0) f = 0;
+    if (f > 1) f = 1;
+    int oitavos = (int)(f * g->width * 8 + 0.5);
+    for (int i = 0; i < g->width; i++) {
+        int cel = oitavos - i * 8;
+        g->next[i] = (unsigned char)(cel < 0 ? 0 : cel > 8 ? 8 : cel);
+    }
+    blocks_emit_row(r, g->y, g->x, g->next, g->shown, g->width, BLOCO_H, g->color);
+}
+
+#endif // TUI_NO_WIDGETS
+
+#define INPUTS_ESC_TIMEOUT 25   // ms de espera pelo restante de uma sequência após ESC
+
+// Inicializa a estrutura de entrada ligada a um descritor/handle arbitrário
+Inputs* inputs_create_fd(tui_fd in) {
+    Inputs* inp = (Inputs*)malloc(sizeof(Inputs));
+    if (!inp) return NULL;
+    inp->last_key = 0;
+    inp->in = in;
+    inp->len = 0;
+    inp->raw_set = false;
+    inp->pasting = false;
+    inp->paste = NULL;
+    inp->paste_len = 0;
+    inp->paste_cap = 0;
+    inp->paste_split = false;
+    inp->error = false;
+    inp->watch_resize = false;
+    inp->size_fd = TUI_FD_INVALID;
+    inp->rows = 0;
+    inp->cols = 0;
+    inp->winch_seen = 0;
+    inp->rec = NULL;
+    inp->refs = 1;
+    return inp;
+}
+
+// Leitor único do console do processo: dois leitores na mesma entrada dividiriam
+// as sequências de escape entre si
+static Inputs* inputs_console_inst = NULL;
+static bool inputs_console_proprio = false; // A biblioteca tem uma referência
+
+// Leitor do console do processo. Todas as chamadas devolvem o mesmo leitor; cada
+// uma deve ter seu inputs_destroy (ele só é liberado na última).
+Inputs* inputs_create() {
+    if (inputs_console_inst) {
+        inputs_console_inst->refs++;
+        return inputs_console_inst;
+    }
+    inputs_console_inst = inputs_create_fd(tui_stdin());
+    return inputs_console_inst;
+}
+
+// Leitor do console usado pela própria biblioteca (animações, inputs_get_key);
+// é o mesmo de inputs_create e fica vivo até inputs_console_destroy
+Inputs* inputs_console(void) {
+    if (!inputs_console_proprio) {
+        if (!inputs_create()) return NULL;
+        inputs_console_proprio = true;
+    }
+    return inputs_console_inst;
+}
+
+// Solta a referência da biblioteca ao leitor do console
+void inputs_console_destroy(void) {
+    if (!inputs_console_proprio) return;
+    inputs_console_proprio = false;
+    inputs_destroy(inputs_console_inst);
+}
+
+// Lê os bytes disponíveis para o buffer interno. Retorna quantos foram lidos,
+// 0 se nada havia (descritor não-bloqueante) e -1 em fim de arquivo ou erro.
+int inputs_read(Inputs* input) {
+    size_t livre = INPUTS_BUF_SIZE - input->len;
+    if (livre == 0) return 0;
+#ifdef _WIN32
+    DWORD lidos = 0;
+    if (!ReadFile(input->in, input->buf + input->len, (DWORD)livre, &lidos, NULL) || lidos == 0) return -1;
+    input->len += lidos;
+    return (int)lidos;
+#else
+    ssize_t n;
+    do { n = read(input->in, input->buf + input->len, livre); } while (n < 0 && errno == EINTR);
+    if (n < 0) return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    if (n == 0) return -1;
+    input->len += (size_t)n;
+    return (int)n;
+#endif
+}
+
+// Descarta os primeiros 'n' bytes do buffer de entrada
+void inputs_consume(Inputs* input, size_t n) {
+    if (n >= input->len) {
+        input->len = 0;
+        return;
+    }
+    memmove(input->buf, input->buf + n, input->len - n);
+    input->len -= n;
+}
+
+// Acrescenta bytes ao bloco colado em montagem (false em falha de alocação)
+static bool inputs_paste_append(Inputs* input, const unsigned char* dados, size_t n) {
+    if (input->paste_len + n + 1 > input->paste_cap) {
+        size_t nova = input->paste_cap ? input->paste_cap : 1024;
+        while (input->paste_len + n + 1 > nova) nova *= 2;
+        if (nova > INPUTS_PASTE_MAX + 1) nova = INPUTS_PASTE_MAX + 1;
+        char* temp = (char*)realloc(input->paste, nova);
+        if (!temp) return false;
+        input->paste = temp;
+        input->paste_cap = nova;
+    }
+    memcpy(input->paste + input->paste_len, dados, n);
+    input->paste_len += n;
+    input->paste[input->paste_len] = '\0';
+    return true;
+}
+
+// Preenche um evento de tecla
+static void inputs_set_key(InputEvent* ev, int key, int mods) {
+    ev->type = EV_KEY;
+    ev->key = key;
+    ev->mods = mods;
+    ev->paste = NULL;
+    ev->paste_len = 0;
+}
+
+// Converte o parâmetro de modificador xterm (1 + bits) para MOD_*
+static int inputs_xterm_mods(int p) {
+    return p > 1 ? (p - 1) & (MOD_SHIFT | MOD_ALT | MOD_CTRL) : 0;
+}
+
+// Tecla de uma sequência terminada em '~' (CSI n ~), ou 0 se desconhecida
+static int inputs_tilde_key(int n) {
+    switch (n) {
+        case 1: case 7: return KEY_EXT(KEY_HOME);
+        case 2:  return KEY_EXT(KEY_INSERT);
+        case 3:  return KEY_EXT(KEY_DELETE);
+        case 4: case 8: return KEY_EXT(KEY_END);
+        case 5:  return KEY_EXT(KEY_PGUP);
+        case 6:  return KEY_EXT(KEY_PGDN);
+        case 11: case 12: case 13: case 14: case 15: return KEY_EXT(KEY_F1 + n - 11);
+        case 17: case 18: case 19: case 20: case 21: return KEY_EXT(KEY_F1 + 5 + n - 17);
+        case 23: return KEY_EXT(KEY_F11);
+        case 24: return KEY_EXT(KEY_F12);
+    }
+    return 0;
+}
+
+// Tecla de um final de CSI/SS3 com letra, ou 0 se desconhecida
+static int inputs_letter_key(unsigned char c) {
+    switch (c) {
+        case 'A': return KEY_EXT(KEY_UP);
+        case 'B': return KEY_EXT(KEY_DOWN);
+        case 'C': return KEY_EXT(KEY_RIGHT);
+        case 'D': return KEY_EXT(KEY_LEFT);
+        case 'H': return KEY_EXT(KEY_HOME);
+        case 'F': return KEY_EXT(KEY_END);
+        case 'P': case 'Q': case 'R': case 'S': return KEY_EXT(KEY_F1 + c - 'P');
+    }
+    return 0;
+}
+
+// Decodifica um caractere UTF-8 em 'p' (n bytes disponíveis). Retorna bytes usados,
+// 0 se a sequência está incompleta.
+static size_t inputs_decode_utf8(const unsigned char* p, size_t n, int* cp) {
+    int len = get_utf8_char_len(p[0]);
+    if ((size_t)len > n) return 0;
+    if (len == 1) {
+        *cp = p[0];
+        return 1;
+    }
+    int v = p[0] & (0x7F >> len);
+    for (int i = 1; i < len; i++) v = (v << 6) | (p[i] & 0x3F);
+    *cp = v > 0x10FFFF ? 0xFFFD : v;  // Fora do Unicode não pode cair no range de KEY_EXT
+    return (size_t)len;
+}
+
+// Decodifica o próximo evento do buffer sem ler da origem. Com 'flush', uma sequência
+// incompleta é entregue como teclas soltas (ex.: ESC isolado após o tempo de espera).
+// Retorna true se 'ev' foi preenchido.
+bool inputs_decode(Inputs* input, InputEvent* ev, bool flush) {
+    static const unsigned char FIM_COLAGEM[] = "\033[201~";
+    const size_t fim_len = sizeof(FIM_COLAGEM) - 1;
+
+    while (input->len > 0) {
+        const unsigned char* b = input->buf;
+        size_t n = input->len;
+
+        // Dentro de um bloco colado: acumula até o marcador de fim. Acima de
+        // INPUTS_PASTE_MAX (ou sem memória) o que já foi montado sai em partes.
+        if (input->pasting) {
+            if (input->paste_split) {
+                input->paste_len = 0;
+                input->paste_split = false;
+            }
+            size_t i = 0;
+            while (i + fim_len <= n && memcmp(b + i, FIM_COLAGEM, fim_len) != 0) i++;
+            bool fim = i + fim_len <= n;
+            // Sem o marcador, guarda a cauda que pode ser o início dele
+            size_t pega = fim ? i : (n >= fim_len ? n - (fim_len - 1) : 0);
+            size_t cabe = INPUTS_PASTE_MAX - input->paste_len;
+            if (pega > cabe) pega = cabe;
+            if (pega > 0 && !inputs_paste_append(input, b, pega)) {
+                if (input->paste_len == 0) {
+                    input->error = true;
+                    return false;
+                }
+                pega = 0;
+                fim = false;
+                input->paste_split = true;
+            } else if (fim && pega == i) {
+                inputs_consume(input, i + fim_len);
+                input->pasting = false;
+            } else {
+                inputs_consume(input, pega);
+                fim = false;
+                if (input->paste_len == INPUTS_PASTE_MAX) input->paste_split = true;
+            }
+            if (!fim && !input->paste_split) return false;
+            ev->type = EV_PASTE;
+            ev->key = 0;
+            ev->mods = 0;
+            ev->paste = input->paste ? input->paste : "";
+            ev->paste_len = input->paste_len;
+            return true;
+        }
+
+        if (b[0] == KEY_ESC) {
+            if (n == 1) {
+                if (!flush) return false;
+                inputs_consume(input, 1);
+                inputs_set_key(ev, KEY_ESC, 0);
+                return true;
+            }
+
+            // CSI: ESC [ parâmetros final
+            if (b[1] == '[') {
+                size_t f = 2;
+                while (f < n && f < 32 && !(b[f] >= 0x40 && b[f] <= 0x7E)) f++;
+                if (f >= n) {
+                    if (!flush) return false;
+                    inputs_consume(input, 1);
+                    inputs_set_key(ev, KEY_ESC, 0);
+                    return true;
+                }
+                int params[4] = {0, 0, 0, 0};
+                int np = 0;
+                for (size_t i = 2; i < f; i++) {
+                    if (b[i] >= '0' && b[i] <= '9') {
+                        if (np == 0) np = 1;
+                        if (np <= 4 && params[np - 1] < 100000) params[np - 1] = params[np - 1] * 10 + (b[i] - '0');
+                    } else if (b[i] == ';') {
+                        if (np == 0) np = 1;
+                        np++;
+                    }
+                }
+                unsigned char final = b[f];
+                inputs_consume(input, f + 1);
+
+                if (final == '~' && params[0] == 200) {
+                    input->pasting = true;
+                    input->paste_split = false;
+                    input->paste_len = 0;
+                    if (input->paste) input->paste[0] = '\0';
+                    continue;
+                }
+                int key = final == '~' ? inputs_tilde_key(params[0]) : inputs_letter_key(final);
+                if (final == 'Z') {
+                    inputs_set_key(ev, '\t', MOD_SHIFT);
+                    return true;
+                }
+                if (key) {
+                    inputs_set_key(ev, key, inputs_xterm_mods(params[1]));
+                    return true;
+                }
+                continue; // Sequência desconhecida: ignora
+            }
+
+            // SS3: ESC O letra (setas em modo aplicação, F1-F4)
+            if (b[1] == 'O') {
+                if (n < 3) {
+                    if (!flush) return false;
+                    inputs_consume(input, 1);
+                    inputs_set_key(ev, KEY_ESC, 0);
+                    return true;
+                }
+                int key = inputs_letter_key(b[2]);
+                inputs_consume(input, 3);
+                if (key) {
+                    inputs_set_key(ev, key, 0);
+                    return true;
+                }
+                continue;
+            }
+
+            // ESC seguido de caractere: Alt + caractere
+            if (b[1] != KEY_ESC) {
+                int cp;
+                size_t used = inputs_decode_utf8(b + 1, n - 1, &cp);
+                if (used == 0) {
+                    if (!flush) return false;
+                    inputs_consume(input, 1);
+                    inputs_set_key(ev, KEY_ESC, 0);
+                    return true;
+                }
+                inputs_consume(input, 1 + used);
+                inputs_set_key(ev, cp == 127 ? KEY_BACKSPACE : cp, MOD_ALT);
+                return true;
+            }
+            inputs_consume(input, 1);
+            inputs_set_key(ev, KEY_ESC, 0);
+            return true;
+        }
+
+        // Teclas de controle
+        if (b[0] == 127 || b[0] == KEY_BACKSPACE) {
+            inputs_consume(input, 1);
+            inputs_set_key(ev, KEY_BACKSPACE, 0);
+            return true;
+        }
+        if (b[0] == '\r' || b[0] == '\n') {
+            inputs_consume(input, 1);
+            inputs_set_key(ev, KEY_ENTER, 0);
+            return true;
+        }
+        if (b[0] < 32) {
+            int c = b[0];
+            inputs_consume(input, 1);
+            inputs_set_key(ev, c, c == '\t' ? 0 : MOD_CTRL);
+            return true;
+        }
+
+        // Caractere UTF-8 completo
+        int cp;
+        size_t used = inputs_decode_utf8(b, n, &cp);
+        if (used == 0) {
+            if (!flush) return false;
+            used = 1;
+            cp = 0xFFFD;
+        }
+        inputs_consume(input, used);
+        inputs_set_key(ev, cp, 0);
+        return true;
+    }
+    return false;
+}
+
+// Prepara a origem para leitura bruta (sem eco/linha; sequências VT no console do Windows)
+static void inputs_raw_mode(Inputs* input) {
+#ifdef _WIN32
+    // O console do processo volta ao modo bruto depois de um tui_restore
+    bool console = input->in == tui_stdin();
+    if (input->raw_set && !(console && !tui_console_alterado)) return;
+    input->raw_set = true;
+    DWORD modo;
+    if (GetConsoleMode(input->in, &modo)) {
+        if (console) {
+            static bool registrado = false;
+            tui_console_modo_orig = modo;
+            tui_console_alterado = true;
+            if (!registrado) atexit(tui_restore);
+            registrado = true;
+        }
+        modo &= ~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT | ENABLE_PROCESSED_INPUT);
+        SetConsoleMode(input->in, modo | ENABLE_VIRTUAL_TERMINAL_INPUT);
+    }
+#else
+    input->raw_set = true;
+    if (input->in == STDIN_FILENO) tui_raw_ativa();
+#endif
+}
+
+#ifdef _WIN32
+// O console sinaliza qualquer registro (soltar tecla, foco, mouse, modificador sozinho),
+// mas só teclas pressionadas com caractere viram bytes. Descarta os outros; true se
+// sobrou algum para ler sem bloquear.
+static bool inputs_console_has_key(HANDLE h) {
+    INPUT_RECORD rec;
+    DWORD n;
+    while (PeekConsoleInputW(h, &rec, 1, &n) && n == 1) {
+        if (rec.EventType == KEY_EVENT && rec.Event.KeyEvent.bKeyDown &&
+            rec.Event.KeyEvent.uChar.UnicodeChar != 0) return true;
+        ReadConsoleInputW(h, &rec, 1, &n);
+    }
+    return false;
+}
+#endif
+
+// Espera até 'ms' milissegundos (-1 = indefinidamente) por bytes na origem
+static bool inputs_wait(Inputs* input, int ms) {
+#ifdef _WIN32
+    DWORD modo;
+    bool console = GetConsoleMode(input->in, &modo) != 0;
+    uint64_t fim = tui_now_us() + (uint64_t)(ms > 0 ? ms : 0) * 1000;
+    while (true) {
+        DWORD espera = INFINITE;
+        if (ms >= 0) {
+            uint64_t agora = tui_now_us();
+            espera = agora >= fim ? 0 : (DWORD)((fim - agora + 999) / 1000);
+        }
+        if (WaitForSingleObject(input->in, espera) != WAIT_OBJECT_0) return false;
+        if (!console || inputs_console_has_key(input->in)) return true;
+        if (ms >= 0 && tui_now_us() >= fim) return false;
+    }
+#else
+    return tui_fd_pronto(input->in, ms);
+#endif
+}
+
+// Passa a gerar EV_RESIZE com o tamanho do terminal 'term' (normalmente a saída).
+// Preenche rows/cols com o tamanho atual; retorna false se 'term' não é um terminal.
+bool inputs_watch_resize(Inputs* input, tui_fd term, int* rows, int* cols) {
+    input->watch_resize = true;
+    input->size_fd = term;
+#ifndef _WIN32
+    tui_winch_install();
+    input->winch_seen = tui_winch_count;
+#endif
+    if (!tui_terminal_size(term, &input->rows, &input->cols)) return false;
+    if (rows) *rows = input->rows;
+    if (cols) *cols = input->cols;
+    return true;
+}
+
+// Gera EV_RESIZE se o tamanho mudou desde a última consulta
+static bool inputs_check_resize(Inputs* input, InputEvent* ev) {
+    if (!input->watch_resize) return false;
+#ifndef _WIN32
+    // Só consulta o terminal depois de um SIGWINCH
+    if (input->winch_seen == tui_winch_count) return false;
+    input->winch_seen = tui_winch_count;
+#endif
+    int rows, cols;
+    if (!tui_terminal_size(input->size_fd, &rows, &cols)) return false;
+    if (rows == input->rows && cols == input->cols) return false;
+    input->rows = rows;
+    input->cols = cols;
+    ev->type = EV_RESIZE;
+    ev->key = 0;
+    ev->mods = 0;
+    ev->paste = NULL;
+    ev->paste_len = 0;
+    ev->rows = rows;
+    ev->cols = cols;
+    return true;
+}
+
+// Espera e decodifica o próximo evento (ver inputs_next_event)
+static int inputs_wait_event(Inputs* input, InputEvent* ev, int timeout_ms) {
+    inputs_raw_mode(input);
+    int restante = timeout_ms;
+    while (true) {
+        if (inputs_check_resize(input, ev)) return 1;
+        if (inputs_decode(input, ev, false)) return 1;
+        if (input->error) return -1;
+
+        // Buffer cheio sem evento completo: entrega como está em vez de esperar mais
+        if (input->len == INPUTS_BUF_SIZE) return inputs_decode(input, ev, true) ? 1 : 0;
+
+        // Sequência incompleta: espera pouco pelo restante antes de entregar como está
+        int espera = restante;
+        if (input->len > 0 && !input->pasting && (espera < 0 || espera > INPUTS_ESC_TIMEOUT)) {
+            espera = INPUTS_ESC_TIMEOUT;
+        }
+#ifdef _WIN32
+        // Sem sinal de redimensionamento no console: consulta o tamanho a cada 100ms
+        if (input->watch_resize && (espera < 0 || espera > 100)) espera = 100;
+#endif
+        if (!inputs_wait(input, espera)) {
+            if (inputs_check_resize(input, ev)) return 1;
+            if (input->len > 0 && !input->pasting && inputs_decode(input, ev, true)) return 1;
+#ifndef _WIN32
+            // Espera interrompida por SIGWINCH: volta para gerar o EV_RESIZE
+            if (input->watch_resize && input->winch_seen != tui_winch_count) continue;
+#endif
+            if (espera == restante) return 0;
+#ifdef _WIN32
+            if (restante > 0 && input->len == 0) restante -= espera;
+#endif
+            continue;
+        }
+        if (inputs_read(input) < 0) return -1;
+    }
+}
+
+#ifndef TUI_NO_RECORDER
+// Grava um evento de entrada (tecla, colagem ou redimensionamento)
+void recorder_input(Recorder* rec, const InputEvent* ev) {
+    if (!rec || rec->error) return;
+    if (ev->type == EV_RESIZE) {
+        unsigned char d[20];
+        size_t n = rec_varint((uint64_t)ev->rows, d);
+        n += rec_varint((uint64_t)ev->cols, d + n);
+        recorder_write(rec, REC_RESIZE, d, n);
+        return;
+    }
+    if (ev->type != EV_KEY && ev->type != EV_PASTE) return;
+
+    // Tecla: key e mods; colagem: mods e os bytes colados após eles
+    size_t colado = ev->type == EV_PASTE ? ev->paste_len : 0;
+    char pequeno[64];
+    char* d = 11 + colado <= sizeof(pequeno) ? pequeno : (char*)malloc(11 + colado);
+    if (!d) {
+        rec->error = true;
+        return;
+    }
+    size_t n = 0;
+    if (ev->type == EV_KEY) {
+        int64_t k = ev->key;
+        n = rec_varint(((uint64_t)k << 1) ^ (uint64_t)(k >> 63), (unsigned char*)d);
+    }
+    d[n++] = (char)ev->mods;
+    if (colado) memcpy(d + n, ev->paste, colado);
+    recorder_write(rec, ev->type == EV_PASTE ? REC_PASTE : REC_INPUT, d, n + colado);
+    if (d != pequeno) free(d);
+}
+
+// Lê um varint do arquivo (false em fim/corrupção)
+static bool rec_read_varint(FILE* f, uint64_t* v) {
+    *v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(f);
+        if (c == EOF) return false;
+        *v |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+// Decodifica um varint de memória; retorna os bytes usados (0 em erro)
+static size_t rec_parse_varint(const unsigned char* p, size_t len, uint64_t* v) {
+    *v = 0;
+    for (size_t i = 0; i < len && i < 10; i++) {
+        *v |= (uint64_t)(p[i] & 0x7F) << (7 * i);
+        if (!(p[i] & 0x80)) return i + 1;
+    }
+    return 0;
+}
+
+// Abre uma gravação; NULL se o arquivo não existe ou não é um log válido
+Replayer* replayer_open(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    char cab[7];
+    if (fread(cab, 1, 7, f) != 7 || memcmp(cab, REC_MAGIC, 6) != 0 || cab[6] < 1 || cab[6] > REC_VERSION) {
+        fclose(f);
+        return NULL;
+    }
+    Replayer* rp = (Replayer*)malloc(sizeof(Replayer));
+    if (!rp) {
+        fclose(f);
+        return NULL;
+    }
+    rp->f = f;
+    rp->version = cab[6];
+    rp->time_us = 0;
+    rp->data = NULL;
+    rp->cap = 0;
+    return rp;
+}
+
+// Lê o próximo registro. Retorna 1 com registro, 0 no fim e -1 se o log está corrompido
+int replayer_next(Replayer* rp, ReplayRecord* out) {
+    int type = fgetc(rp->f);
+    if (type == EOF) return 0;
+    uint64_t delta, len;
+    if (!rec_read_varint(rp->f, &delta) || !rec_read_varint(rp->f, &len)) return -1;
+    if (len > rp->cap) {
+        char* temp = (char*)realloc(rp->data, (size_t)len);
+        if (!temp) return -1;
+        rp->data = temp;
+        rp->cap = (size_t)len;
+    }
+    if (len && fread(rp->data, 1, (size_t)len, rp->f) != len) return -1;
+    rp->time_us += delta;
+
+    out->type = type;
+    out->time_us = rp->time_us;
+    out->data = rp->data;
+    out->len = (size_t)len;
+    memset(&out->ev, 0, sizeof(out->ev));
+
+    const unsigned char* p = (const unsigned char*)rp->data;
+    if (type == REC_INPUT) {
+        uint64_t z;
+        size_t n = rec_parse_varint(p, (size_t)len, &z);
+        if (n == 0 || n >= len) return -1;
+        int key = (int)(int64_t)((z >> 1) ^ (~(z & 1) + 1));
+        out->ev.mods = p[n++];
+        if (key == 0 && rp->version == 1) {
+            // Versão 1 gravava a colagem como tecla 0
+            out->ev.type = EV_PASTE;
+            out->ev.paste = rp->data + n;
+            out->ev.paste_len = (size_t)len - n;
+        } else {
+            // Até a versão 2 as teclas estendidas ficavam em 1000 + scan code
+            if (rp->version <= 2 && key >= 1000 && key < 1256) key = KEY_EXT(key - 1000);
+            out->ev.type = EV_KEY;
+            out->ev.key = key;
+        }
+    } else if (type == REC_PASTE) {
+        if (len == 0) return -1;
+        out->ev.type = EV_PASTE;
+        out->ev.mods = p[0];
+        out->ev.paste = rp->data + 1;
+        out->ev.paste_len = (size_t)len - 1;
+    } else if (type == REC_RESIZE) {
+        uint64_t rows, cols;
+        size_t n = rec_parse_varint(p, (size_t)len, &rows);
+        if (n == 0 || rec_parse_varint(p + n, (size_t)len - n, &cols) == 0) return -1;
+        out->ev.type = EV_RESIZE;
+        out->ev.rows = (int)rows;
+        out->ev.cols = (int)cols;
+    }
+    return 1;
+}
+
+// Reproduz a gravação no renderer 'r' (qualquer destino). speed 1.0 = tempo real,
+// 2.0 = duas vezes mais rápido, <= 0 = sem pausas (útil como carga de benchmark).
+// Retorna o número de quadros reproduzidos ou -1 se o log está corrompido.
+long replayer_play(Replayer* rp, Renderer* r, double speed, ReplayInputFn on_input, void* user) {
+    ReplayRecord rec;
+    long quadros = 0;
+    uint64_t inicio = tui_now_us();
+    uint64_t base = rp->time_us;
+    int res;
+    while ((res = replayer_next(rp, &rec)) == 1) {
+        if (speed > 0) {
+            uint64_t alvo = inicio + (uint64_t)((double)(rec.time_us - base) / speed);
+            uint64_t agora = tui_now_us();
+            if (alvo > agora + 1000) tui_sleep_ms((unsigned)((alvo - agora) / 1000));
+        }
+        if (rec.type == REC_FRAME) {
+            renderer_add_raw(r, rec.data, rec.len);
+            renderer_render(r);
+            quadros++;
+        } else if ((rec.type == REC_INPUT || rec.type == REC_RESIZE || rec.type == REC_PASTE) && on_input) {
+            on_input(&rec.ev, user);
+        }
+    }
+    return res < 0 ? -1 : quadros;
+}
+
+void replayer_close(Replayer* rp) {
+    if (!rp) return;
+    fclose(rp->f);
+    free(rp->data);
+    free(rp);
+}
+#endif // TUI_NO_RECORDER
+
+// Lê e decodifica o próximo evento, esperando até timeout_ms (-1 = bloqueia).
+// Retorna 1 com evento, 0 se o tempo acabou e -1 em fim de arquivo ou erro.
+int inputs_next_event(Inputs* input, InputEvent* ev, int timeout_ms) {
+    int res = inputs_wait_event(input, ev, timeout_ms);
+    if (res == 1) recorder_input(input->rec, ev);
+    return res;
+}
+
+#ifndef TUI_NO_RECORDER
+// Grava os eventos lidos em 'rec' (NULL desliga); o gravador não pertence ao Inputs
+void inputs_set_recorder(Inputs* input, Recorder* rec) {
+    input->rec = rec;
+}
+#endif
+
+// Libera a memória da estrutura
+void inputs_destroy(Inputs* input) {
+    if (input) {
+        if (input == inputs_console_inst) {
+            if (--input->refs > 0) return;
+            inputs_console_inst = NULL;
+            inputs_console_proprio = false;
+        }
+        if (input->raw_set && input->in == tui_stdin()) tui_restore();
+        free(input->paste);
+        free(input);
+    }
+}
+
+// Calcula o tamanho visual da string (ignora sequências ANSI)
+int inputs_visible_len(const char* s) {
+    int l = 0;
+    bool in_esc = false;
+    for (int i = 0; s[i] != '\0'; i++) {
+        if (s[i] == '\x1b') {
+            in_esc = true;
+        } else if (in_esc && s[i] == 'm') {
+            in_esc = false;
+        } else if (!in_esc) {
+            // Conta apenas bytes iniciais de caracteres UTF-8
+            if ((s[i] & 0xC0) != 0x80) l++;
+        }
+    }
+    return l;
+}
+
+// Função auxiliar para identificar bytes de continuação do UTF-8
+bool is_utf8_continuation(char c) {
+    // Em UTF-8, bytes que começam com 10xxxxxx (0x80 a 0xBF) são continuações
+    return (c & 0xC0) == 0x80;
+}
+
+#ifndef TUI_NO_PROMPT
+// ---------------------------------------------------------------------------
+// Buffer com lacuna (gap buffer) para edição de linha: inserir e apagar no cursor é O(1)
+// amortizado; mover o cursor desloca apenas os bytes entre a posição antiga e a nova.
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    char* data;         // Bytes UTF-8: [0, gap_start) antes do cursor, [gap_end, cap) depois
+    size_t cap;         // Capacidade total
+    size_t gap_start;   // Início da lacuna (posição do cursor em bytes)
+    size_t gap_end;     // Fim da lacuna
+    int chars;          // Total de caracteres
+    int cursor;         // Posição do cursor em caracteres
+} GapBuffer;
+
+// Inicializa um buffer vazio
+static bool gapbuf_init(GapBuffer* gb, size_t cap) {
+    if (cap < 16) cap = 16;
+    gb->data = (char*)malloc(cap);
+    gb->cap = cap;
+    gb->gap_start = 0;
+    gb->gap_end = cap;
+    gb->chars = 0;
+    gb->cursor = 0;
+    return gb->data != NULL;
+}
+
+// Libera o buffer
+static void gapbuf_free(GapBuffer* gb) {
+    free(gb->data);
+    gb->data = NULL;
+}
+
+// Garante espaço para 'n' bytes na lacuna
+static bool gapbuf_reserve(GapBuffer* gb, size_t n) {
+    size_t gap = gb->gap_end - gb->gap_start;
+    if (gap >= n) return true;
+    size_t depois = gb->cap - gb->gap_end;
+    size_t nova = gb->cap * 2;
+    while (nova - gb->gap_start - depois < n) nova *= 2;
+    char* temp = (char*)realloc(gb->data, nova);
+    if (!temp) return false;
+    memmove(temp + nova - depois, temp + gb->gap_end, depois);
+    gb->data = temp;
+    gb->gap_end = nova - depois;
+    gb->cap = nova;
+    return true;
+}
+
+// Insere 'n' bytes UTF-8 ('chars' caracteres) no cursor
+static bool gapbuf_insert(GapBuffer* gb, const char* texto, size_t n, int chars) {
+    if (!gapbuf_reserve(gb, n)) return false;
+    memcpy(gb->data + gb->gap_start, texto, n);
+    gb->gap_start += n;
+    gb->chars += chars;
+    gb->cursor += chars;
+    return true;
+}
+
+// Move o cursor um caractere para a esquerda
+static bool gapbuf_left(GapBuffer* gb) {
+    if (gb->gap_start == 0) return false;
+    do {
+        gb->data[--gb->gap_end] = gb->data[--gb->gap_start];
+    } while (gb->gap_start > 0 && is_utf8_continuation(gb->data[gb->gap_end]));
+    gb->cursor--;
+    return true;
+}
+
+// Move o cursor um caractere para a direita
+static bool gapbuf_right(GapBuffer* gb) {
+    if (gb->gap_end == gb->cap) return false;
+    int n = get_utf8_char_len((unsigned char)gb->data[gb->gap_end]);
+    for (int i = 0; i < n && gb->gap_end < gb->cap; i++) {
+        gb->data[gb->gap_start++] = gb->data[gb->gap_end++];
+    }
+    gb->cursor++;
+    return true;
+}
+
+// Apaga o caractere antes do cursor
+static bool gapbuf_delete_back(GapBuffer* gb) {
+    if (gb->gap_start == 0) return false;
+    do {
+        gb->gap_start--;
+    } while (gb->gap_start > 0 && is_utf8_continuation(gb->data[gb->gap_start]));
+    gb->chars--;
+    gb->cursor--;
+    return true;
+}
+
+// Apaga o caractere sob o cursor
+static bool gapbuf_delete_fwd(GapBuffer* gb) {
+    if (gb->gap_end == gb->cap) return false;
+    gb->gap_end += get_utf8_char_len((unsigned char)gb->data[gb->gap_end]);
+    if (gb->gap_end > gb->cap) gb->gap_end = gb->cap;
+    gb->chars--;
+    return true;
+}
+
+// Byte antes/depois do cursor (0 nas pontas)
+static char gapbuf_before(const GapBuffer* gb) {
+    return gb->gap_start > 0 ? gb->data[gb->gap_start - 1] : 0;
+}
+static char gapbuf_after(const GapBuffer* gb) {
+    return gb->gap_end < gb->cap ? gb->data[gb->gap_end] : 0;
+}
+
+// Move o cursor para o início da palavra anterior
+static void gapbuf_word_left(GapBuffer* gb) {
+    while (gapbuf_before(gb) == ' ' && gapbuf_left(gb)) {}
+    while (gb->gap_start > 0 && gapbuf_before(gb) != ' ' && gapbuf_left(gb)) {}
+}
+
+// Move o cursor para o fim da palavra seguinte
+static void gapbuf_word_right(GapBuffer* gb) {
+    while (gapbuf_after(gb) == ' ' && gapbuf_right(gb)) {}
+    while (gb->gap_end < gb->cap && gapbuf_after(gb) != ' ' && gapbuf_right(gb)) {}
+}
+
+// Apaga a palavra antes do cursor (Ctrl+W)
+static void gapbuf_delete_word(GapBuffer* gb) {
+    while (gapbuf_before(gb) == ' ' && gapbuf_delete_back(gb)) {}
+    while (gb->gap_start > 0 && gapbuf_before(gb) != ' ' && gapbuf_delete_back(gb)) {}
+}
+
+// Copia o conteúdo para uma string nova terminada em nulo
+static char* gapbuf_to_string(const GapBuffer* gb) {
+    size_t depois = gb->cap - gb->gap_end;
+    char* s = (char*)malloc(gb->gap_start + depois + 1);
+    if (!s) return NULL;
+    memcpy(s, gb->data, gb->gap_start);
+    memcpy(s + gb->gap_start, gb->data + gb->gap_end, depois);
+    s[gb->gap_start + depois] = '\0';
+    return s;
+}
+
+// Endereço do byte lógico 'pos' (ignora a lacuna)
+static const char* gapbuf_at(const GapBuffer* gb, size_t pos) {
+    return pos < gb->gap_start ? gb->data + pos : gb->data + gb->gap_end + (pos - gb->gap_start);
+}
+
+// Adiciona ao renderer os caracteres [from, to) do buffer
+static void gapbuf_emit(const GapBuffer* gb, Renderer* r, int from, int to) {
+    size_t total = gb->cap - (gb->gap_end - gb->gap_start);
+    size_t pos = 0;
+    int c = 0;
+    while (pos < total && c < from) {
+        pos += get_utf8_char_len((unsigned char)*gapbuf_at(gb, pos));
+        c++;
+    }
+    size_t ini = pos;
+    while (pos < total && c < to) {
+        pos += get_utf8_char_len((unsigned char)*gapbuf_at(gb, pos));
+        c++;
+    }
+    if (pos > total) pos = total;
+
+    // A faixa pode atravessar a lacuna: até dois pedaços contíguos
+    if (ini < gb->gap_start && pos > gb->gap_start) {
+        renderer_add_raw(r, gb->data + ini, gb->gap_start - ini);
+        renderer_add_raw(r, gb->data + gb->gap_end, pos - gb->gap_start);
+    } else if (pos > ini) {
+        renderer_add_raw(r, gapbuf_at(gb, ini), pos - ini);
+    }
+}
+
+// Substitui todo o conteúdo do buffer (cursor no fim)
+static void gapbuf_set(GapBuffer* gb, const char* texto) {
+    gb->gap_start = 0;
+    gb->gap_end = gb->cap;
+    gb->chars = 0;
+    gb->cursor = 0;
+    size_t n = strlen(texto);
+    gapbuf_insert(gb, texto, n, interface_visible_len(texto));
+}
+
+// ---------------------------------------------------------------------------
+// Histórico de prompts: navegação com setas, busca reversa (Ctrl+R) e arquivo
+// com uma entrada por linha (acrescentada a cada Enter, compactada ao carregar)
+// ---------------------------------------------------------------------------
+
+// Cria um histórico com até max_entries entradas (<= 0 usa 1000)
+History* history_create(int max_entries) {
+    History* h = (History*)calloc(1, sizeof(History));
+    if (!h) return NULL;
+    h->max = max_entries > 0 ? max_entries : 1000;
+    h->items = (char**)malloc(h->max * sizeof(char*));
+    if (!h->items) {
+        free(h);
+        return NULL;
+    }
+    return h;
+}
+
+// Entrada 'i', contando da mais antiga (0) até a mais recente (count - 1)
+const char* history_get(const History* h, int i) {
+    return h->items[(h->head + i) % h->max];
+}
+
+// Libera o histórico
+void history_destroy(History* h) {
+    if (!h) return;
+    for (int i = 0; i < h->count; i++) free(h->items[(h->head + i) % h->max]);
+    free(h->items);
+    free(h->path);
+    free(h);
+}
+
+// Acrescenta uma entrada na memória (ignora vazias e repetição da última)
+static bool history_push(History* h, const char* line) {
+    if (!line || !*line) return false;
+    if (h->count > 0 && strcmp(history_get(h, h->count - 1), line) == 0) return false;
+    char* copia = (char*)malloc(strlen(line) + 1);
+    if (!copia) return false;
+    strcpy(copia, line);
+    // Cheio: a nova entrada ocupa o lugar da mais antiga, sem deslocar as demais
+    if (h->count == h->max) {
+        free(h->items[h->head]);
+        h->items[h->head] = copia;
+        h->head = (h->head + 1) % h->max;
+        return true;
+    }
+    h->items[(h->head + h->count++) % h->max] = copia;
+    return true;
+}
+
+// Grava todas as entradas no arquivo (uma por linha). Retorna 0 ou -1.
+int history_save(const History* h, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return -1;
+    for (int i = 0; i < h->count; i++) {
+        fputs(history_get(h, i), f);
+        fputc('\n', f);
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+// Carrega o arquivo e passa a acrescentar nele cada nova entrada. Se o arquivo
+// passou do limite, é reescrito só com as entradas mantidas. Retorna 0 ou -1.
+int history_load(History* h, const char* path) {
+    free(h->path);
+    h->path = (char*)malloc(strlen(path) + 1);
+    if (h->path) strcpy(h->path, path);
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+    int lidas = 0;
+    size_t cap = 256, len = 0;
+    char* linha = (char*)malloc(cap);
+    int c;
+    while (linha) {
+        c = fgetc(f);
+        if (c != '\n' && c != EOF) {
+            if (len + 1 >= cap) {
+                char* temp = (char*)realloc(linha, cap * 2);
+                if (!temp) break;
+                linha = temp;
+                cap *= 2;
+            }
+            linha[len++] = (char)c;
             continue;
         }
-        
-        int char_len = get_utf8_char_len(c);
-        renderer_add_raw(r, (char*)&texto[i], char_len);
-        renderer_render(r); // Flush obrigatório para animação
-        
-        i += char_len;
-        
-        if (!pular) {
-            if (_kbhit()) {
-                _getch(); 
-                pular = true;
-            } else {
-                Sleep(sleep_ms);
-            }
+        // Última linha sem '\n' também conta; '\r' de arquivos do Windows é removido
+        if (len > 0 && linha[len - 1] == '\r') len--;
+        if (c == '\n' || len > 0) {
+            linha[len] = '\0';
+            history_push(h, linha);
+            lidas++;
         }
+        if (c == EOF) break;
+        len = 0;
     }
-    renderer_add(r, ui->B_RESET);
-    renderer_render(r);
+    free(linha);
+    fclose(f);
+
+    if (lidas > h->count) history_save(h, path);
+    return 0;
 }
 
-// Imprime texto estático respeitando quebras de linha manuais (\n)
-void interface_text_(Interface* ui, Renderer* r, int x, int y, const char* texto, const char* text_color, const char* bg_color) {
-    
-    if (!bg_color) bg_color = "";
-    if (!text_color) text_color = "";
-    
-    const char* start = texto;
-    const char* end;
-    int current_y = y;
+// Acrescenta uma entrada (e ao arquivo, se houver um carregado)
+void history_add(History* h, const char* line) {
+    if (!history_push(h, line) || !h->path) return;
+    FILE* f = fopen(h->path, "ab");
+    if (!f) return;
+    fputs(line, f);
+    fputc('\n', f);
+    fclose(f);
+}
 
-    // Itera sobre as linhas separadas por \n
-    while ((end = strchr(start, '\n')) != NULL) {
-        int len = (int)(end - start);        
-        interface_move_cursor(r, current_y, x);
-        if (*bg_color) renderer_add(r, bg_color);
-        if (*text_color) renderer_add(r, text_color);
-        renderer_add_raw(r, start, len);
-        renderer_add(r, ui->B_RESET);
-        
-        start = end + 1;
-        current_y++;
+// Procura, do índice 'from' para trás, a entrada mais recente que contém 'query' (-1 se nenhuma)
+static int history_search(const History* h, const char* query, int from) {
+    if (from >= h->count) from = h->count - 1;
+    for (int i = from; i >= 0; i--) {
+        if (strstr(history_get(h, i), query)) return i;
     }
-    
-    // Imprime o último pedaço (ou a string inteira se não houver \n)
-    if (*start) {
-        interface_move_cursor(r, current_y, x);
-        if (*bg_color) renderer_add(r, bg_color);
-        if (*text_color) renderer_add(r, text_color);
-        renderer_add(r, start);
-        renderer_add(r, ui->B_RESET);
+    return -1;
+}
+
+// ---------------------------------------------------------------------------
+// Índice de completação: candidatos ordenados em um vetor, busca por prefixo em
+// O(log n). As strings ficam em blocos contíguos para evitar um malloc por item.
+// ---------------------------------------------------------------------------
+
+// Cria um índice vazio
+Completer* completer_create(void) {
+    return (Completer*)calloc(1, sizeof(Completer));
+}
+
+// Libera o índice e as strings
+void completer_destroy(Completer* c) {
+    if (!c) return;
+    while (c->blocks) {
+        CompleterBlock* prox = c->blocks->next;
+        free(c->blocks);
+        c->blocks = prox;
+    }
+    free(c->items);
+    free(c);
+}
+
+// Adiciona um candidato (copiado). Retorna 0 ou -1 em falha de alocação.
+int completer_add(Completer* c, const char* item) {
+    size_t n = strlen(item) + 1;
+    if (n > COMPLETER_BLOCO) return -1;
+    if (!c->blocks || c->blocks->used + n > COMPLETER_BLOCO) {
+        CompleterBlock* b = (CompleterBlock*)malloc(sizeof(CompleterBlock));
+        if (!b) return -1;
+        b->next = c->blocks;
+        b->used = 0;
+        c->blocks = b;
+    }
+    if (c->count >= c->capacity) {
+        size_t nova = c->capacity ? c->capacity * 2 : 1024;
+        char** temp = (char**)realloc(c->items, nova * sizeof(char*));
+        if (!temp) return -1;
+        c->items = temp;
+        c->capacity = nova;
+    }
+    char* dest = c->blocks->data + c->blocks->used;
+    memcpy(dest, item, n);
+    c->blocks->used += n;
+    c->items[c->count++] = dest;
+    c->sorted = false;
+    return 0;
+}
+
+static int completer_cmp(const void* a, const void* b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+// Ordena e remove duplicatas (chamado automaticamente na primeira busca após adições)
+void completer_build(Completer* c) {
+    if (c->sorted) return;
+    qsort(c->items, c->count, sizeof(char*), completer_cmp);
+    size_t j = 0;
+    for (size_t i = 0; i < c->count; i++) {
+        if (j == 0 || strcmp(c->items[j - 1], c->items[i]) != 0) c->items[j++] = c->items[i];
+    }
+    c->count = j;
+    c->sorted = true;
+}
+
+// Localiza os candidatos que começam com prefix[0..len). Retorna quantos são e
+// grava em *first o índice do primeiro.
+size_t completer_find(Completer* c, const char* prefix, size_t len, size_t* first) {
+    completer_build(c);
+
+    // Limite inferior: primeiro item >= prefixo
+    size_t lo = 0, hi = c->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strncmp(c->items[mid], prefix, len) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    *first = lo;
+
+    // Limite superior: primeiro item cujo prefixo é maior
+    hi = c->count;
+    size_t ini = lo;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strncmp(c->items[mid], prefix, len) <= 0) lo = mid + 1;
+        else hi = mid;
     }
+    return lo - ini;
+}
+
+// Candidato de índice i
+const char* completer_get(const Completer* c, size_t i) {
+    return i < c->count ? c->items[i] : NULL;
+}
+
+// Implementação do hook apoiada em um Completer (user = Completer*)
+bool completer_prompt_hook(const char* prefix, size_t len, const char** match, size_t* common, void* user) {
+    Completer* c = (Completer*)user;
+    if (len == 0) return false;
+    size_t first;
+    size_t n = completer_find(c, prefix, len, &first);
+    if (n == 0) return false;
+
+    const char* a = c->items[first];
+    const char* b = c->items[first + n - 1];
+    size_t k = len;
+    while (a[k] && a[k] == b[k]) k++;
+    *match = a;
+    *common = k;
+    return true;
 }
 
+// Estado visual do campo de edição
 typedef struct {
-    int last_key;
-} Inputs;
+    Renderer* r;
+    int x, y, width;
+    const char* color;
+    int scroll;     // Primeiro caractere visível
+    int drawn;      // Colunas desenhadas na última pintura (texto + sugestão)
+    int ghost;      // Colunas da sugestão desenhada após o texto
+} PromptView;
 
-// Inicializa a estrutura de controle de entrada
-Inputs* inputs_create() {
-    Inputs* inp = (Inputs*)malloc(sizeof(Inputs));
-    return inp;
+// Bytes dos primeiros caracteres de 's' que cabem em 'max_cols' colunas ('cols' recebe
+// quantas). Para num caractere UTF-8 incompleto (ex.: texto cortado por snprintf).
+static size_t prompt_fit(const char* s, int max_cols, int* cols) {
+    size_t len = strlen(s), pos = 0;
+    int n = 0;
+    while (pos < len && n < max_cols) {
+        size_t k = (size_t)get_utf8_char_len((unsigned char)s[pos]);
+        if (pos + k > len) break;
+        size_t j = 1;
+        while (j < k && is_utf8_continuation(s[pos + j])) j++;
+        if (j < k) break;
+        pos += k;
+        n++;
+    }
+    *cols = n;
+    return pos;
 }
 
-// Libera a memória da estrutura
-void inputs_destroy(Inputs* input) {
-    if (input) free(input);
+// Repinta o campo a partir do caractere 'from' (apenas o sufixo alterado), desenha a
+// sugestão de completação 'ghost' (esmaecida, após o fim do texto) e posiciona o cursor
+static void prompt_repaint(PromptView* v, const GapBuffer* gb, int from, const char* ghost) {
+    // Mantém o cursor dentro da janela visível
+    int scroll = v->scroll;
+    if (gb->cursor < scroll) scroll = gb->cursor;
+    if (gb->cursor >= scroll + v->width) scroll = gb->cursor - v->width + 1;
+    if (scroll != v->scroll) {
+        v->scroll = scroll;
+        from = scroll; // Rolou: redesenha o campo inteiro
+    }
+    if (from < scroll) from = scroll;
+
+    // A sugestão só aparece com o cursor no fim do texto
+    int fim = gb->chars < scroll + v->width ? gb->chars : scroll + v->width;
+    int livres = scroll + v->width - fim;
+    if (!ghost || gb->cursor != gb->chars) ghost = NULL;
+    if ((ghost || v->ghost > 0) && from > gb->chars) from = gb->chars;
+
+    int visiveis = fim - scroll;
+    if (from < scroll + v->width && (from < fim || from - scroll < v->drawn || ghost)) {
+        renderer_move_cursor(v->r, v->y, v->x + (from - scroll));
+        if (from < fim) gapbuf_emit(gb, v->r, from, fim);
+        int col = visiveis > from - scroll ? visiveis : from - scroll;
+
+        v->ghost = 0;
+        if (ghost && livres > 0) {
+            size_t bytes = prompt_fit(ghost, livres, &v->ghost);
+            renderer_add(v->r, "\033[2m");
+            renderer_add_raw(v->r, ghost, bytes);
+            renderer_add(v->r, "\033[0m");
+            if (v->color) renderer_add(v->r, v->color);
+            col += v->ghost;
+        }
+        renderer_add_repeat(v->r, " ", v->drawn - col);
+        v->drawn = visiveis + v->ghost;
+    }
+    renderer_move_cursor(v->r, v->y, v->x + (gb->cursor - scroll));
+    renderer_render(v->r);
 }
 
-// Calcula o tamanho visual da string (ignora sequências ANSI)
-int inputs_visible_len(const char* s) {
-    int l = 0;
-    bool in_esc = false;
-    for (int i = 0; s[i] != '\0'; i++) {
-        if (s[i] == '\x1b') {
-            in_esc = true;
-        } else if (in_esc && s[i] == 'm') {
-            in_esc = false;
-        } else if (!in_esc) {
-            // Conta apenas bytes iniciais de caracteres UTF-8
-            if ((s[i] & 0xC0) != 0x80) l++;
+// Pinta um texto fixo no campo (ex.: estado da busca reversa)
+static void prompt_paint_text(PromptView* v, const char* texto) {
+    int cols;
+    size_t bytes = prompt_fit(texto, v->width, &cols);
+    renderer_move_cursor(v->r, v->y, v->x);
+    renderer_add_raw(v->r, texto, bytes);
+    renderer_add_repeat(v->r, " ", v->drawn - cols);
+    v->drawn = cols;
+    v->ghost = 0;
+    renderer_move_cursor(v->r, v->y, v->x + cols);
+    renderer_render(v->r);
+}
+
+// Insere texto (colado ou digitado) no cursor; quebras de linha e controles viram espaço
+static void prompt_insert(GapBuffer* gb, int max_chars, const char* texto, size_t n) {
+    for (size_t i = 0; i < n; ) {
+        if (max_chars > 0 && gb->chars >= max_chars) break;
+        unsigned char c = (unsigned char)texto[i];
+        size_t char_len = (size_t)get_utf8_char_len(c);
+        if (i + char_len > n) break;
+
+        // Copia de uma vez a sequência de caracteres imprimíveis
+        size_t j = i;
+        int chars = 0;
+        while (j < n && (max_chars <= 0 || gb->chars + chars < max_chars)) {
+            unsigned char d = (unsigned char)texto[j];
+            if (d < 32 || d == 127) break;
+            size_t l = (size_t)get_utf8_char_len(d);
+            if (j + l > n) break;
+            j += l;
+            chars++;
         }
+        if (j > i) {
+            gapbuf_insert(gb, texto + i, j - i, chars);
+            i = j;
+            continue;
+        }
+        if (c == '\r' && i + 1 < n && texto[i + 1] == '\n') { i++; continue; }
+        gapbuf_insert(gb, " ", 1, 1);
+        i++;
     }
-    return l;
 }
 
-// Função auxiliar para identificar bytes de continuação do UTF-8
-bool is_utf8_continuation(char c) {
-    // Em UTF-8, bytes que começam com 10xxxxxx (0x80 a 0xBF) são continuações
-    return (c & 0xC0) == 0x80;
+// Consulta o hook para a palavra antes do cursor (só com o cursor no fim do texto).
+// Retorna o restante do primeiro candidato e grava em *common_extra quantos bytes
+// dele são comuns a todos os candidatos.
+static const char* prompt_suggest(const PromptConfig* cfg, const GapBuffer* gb, size_t* common_extra) {
+    if (!cfg->complete || gb->cursor != gb->chars || gb->gap_start == 0) return NULL;
+    size_t ini = gb->gap_start;
+    while (ini > 0 && gb->data[ini - 1] != ' ') ini--;
+    size_t len = gb->gap_start - ini;
+    if (len == 0) return NULL;
+
+    const char* match;
+    size_t common;
+    if (!cfg->complete(gb->data + ini, len, &match, &common, cfg->complete_user)) return NULL;
+    *common_extra = common - len;
+    return match + len;
 }
 
-char* inputs_prompt(Inputs* input, Renderer* r, int x, int y, int max_len, const char* input_color) {
-    if (max_len <= 0) max_len = 255;    
-    
-    renderer_move_cursor(r, y, x);
-    if (input_color && *input_color) renderer_add(r, input_color);
-    renderer_render(r);
+// Prompt de linha com edição completa: setas, Home/End, Del, Ctrl+W (apaga palavra),
+// Ctrl+U/Ctrl+K (apaga até o início/fim), Ctrl/Alt+setas (pula palavra) e colagem.
+// Com histórico: cima/baixo navegam e Ctrl+R faz busca reversa incremental.
+// Com completação: a sugestão aparece esmaecida; Tab completa o prefixo comum e
+// seta direita no fim aceita a sugestão inteira.
+char* inputs_prompt_cfg(Inputs* input, Renderer* r, int x, int y, const PromptConfig* cfg) {
+    PromptView v = { r, x, y, cfg->width > 0 ? cfg->width : 255, cfg->color, 0, 0, 0 };
+    GapBuffer gb;
+    if (!gapbuf_init(&gb, 256)) return NULL;
 
-    // Aloca buffer com folga (4x) pois caracteres UTF-8 podem ter até 4 bytes cada
-    char* buffer = (char*)calloc((max_len * 4) + 1, sizeof(char)); 
-    int current_bytes = 0; // Bytes totais usados no buffer
-    int visual_len = 0;    // Quantidade de caracteres visíveis na tela
-    
-    wint_t ch; // Usamos wint_t para capturar o caractere Unicode completo
+    History* h = cfg->history;
+    int hist_pos = h ? h->count : 0;    // h->count = linha nova
+    char* rascunho = NULL;              // Linha em edição antes de navegar no histórico
+
+    // Estado da busca reversa
+    bool buscando = false;
+    char consulta[256];
+    size_t consulta_len = 0;
+    int achado = -1;
 
+    renderer_add(r, "\033[?2004h"); // Ativa bracketed paste
+    if (cfg->color && *cfg->color) renderer_add(r, cfg->color);
+    if (cfg->initial) prompt_insert(&gb, cfg->max_chars, cfg->initial, strlen(cfg->initial));
+    size_t comum = 0;
+    const char* sugestao = prompt_suggest(cfg, &gb, &comum);
+    prompt_repaint(&v, &gb, 0, sugestao);
+
+    InputEvent ev;
     while (true) {
-        ch = _getwch(); // _getwch captura Unicode (Wide Char)
-        
-        // Ignora teclas estendidas (setas, F1-F12) se necessário
-        if (ch == 0 || ch == 0xE0) {
-            _getwch(); // Consome o segundo código da tecla estendida
+        if (inputs_next_event(input, &ev, -1) < 0) break;
+
+        // Busca reversa: teclas editam a consulta até aceitar ou cancelar
+        if (buscando) {
+            if (ev.type != EV_KEY) continue;
+            int ch = ev.key;
+            bool fim_busca = true;
+            if (ch == 18) {                                         // Ctrl+R: próxima mais antiga
+                if (achado > 0) {
+                    int prox = history_search(h, consulta, achado - 1);
+                    if (prox >= 0) achado = prox;
+                }
+                fim_busca = false;
+            } else if (ch == KEY_BACKSPACE) {
+                if (consulta_len > 0) {
+                    do { consulta_len--; } while (consulta_len > 0 && is_utf8_continuation(consulta[consulta_len]));
+                    consulta[consulta_len] = '\0';
+                    achado = history_search(h, consulta, h->count - 1);
+                }
+                fim_busca = false;
+            } else if (ch >= 32 && !KEY_IS_EXT(ch) && !(ev.mods & (MOD_CTRL | MOD_ALT))) {
+                char temp_utf8[4];
+                int n = tui_utf8_encode((unsigned long)ch, temp_utf8);
+                if (n > 0 && consulta_len + n < sizeof(consulta)) {
+                    memcpy(consulta + consulta_len, temp_utf8, n);
+                    consulta_len += n;
+                    consulta[consulta_len] = '\0';
+                    int prox = history_search(h, consulta, achado >= 0 ? achado : h->count - 1);
+                    if (prox >= 0) achado = prox;
+                }
+                fim_busca = false;
+            } else if (ch == KEY_ESC || ch == 7) {                  // Esc/Ctrl+G: cancela
+                achado = -1;
+            }
+
+            if (!fim_busca) {
+                char status[512];
+                snprintf(status, sizeof(status), "(busca)'%s': %s", consulta, achado >= 0 ? history_get(h, achado) : "");
+                prompt_paint_text(&v, status);
+                continue;
+            }
+            buscando = false;
+            if (achado >= 0) {
+                gapbuf_set(&gb, history_get(h, achado));
+                hist_pos = achado;
+            }
+            v.scroll = 0;
+            sugestao = prompt_suggest(cfg, &gb, &comum);
+            prompt_repaint(&v, &gb, 0, sugestao);
+            if (ch != KEY_ENTER) continue; // Enter aceita e envia
+            break;
+        }
+
+        int antes = gb.cursor;
+        // Bloco colado: insere tudo de uma vez e redesenha uma única vez
+        if (ev.type == EV_PASTE) {
+            prompt_insert(&gb, cfg->max_chars, ev.paste, ev.paste_len);
+            sugestao = prompt_suggest(cfg, &gb, &comum);
+            prompt_repaint(&v, &gb, antes, sugestao);
             continue;
         }
+        if (ev.type != EV_KEY) continue;
 
-        if (ch == KEY_ENTER) {
-            // Limpa visualmente (preenche com espaços)
-            renderer_move_cursor(r, y, x);
-            for(int k=0; k < visual_len; k++) renderer_add(r, " ");
-            
-            // Reseta cor e cursor
-            renderer_move_cursor(r, y, x);
-            renderer_add(r, "\033[0m");
-            renderer_render(r);
-            
-            return buffer;
-        }
-        else if (ch == KEY_BACKSPACE) {
-            if (current_bytes > 0) {
-                // Lógica de Backspace para UTF-8:
-                // Remove bytes do buffer até encontrar o byte inicial do caractere
-                do {
-                    current_bytes--;
-                } while (current_bytes > 0 && is_utf8_continuation(buffer[current_bytes]));
-                
-                buffer[current_bytes] = '\0'; // Trunca a string
-                visual_len--;
+        int ch = ev.key;
+        bool ctrl = (ev.mods & MOD_CTRL) != 0;
+        bool alt = (ev.mods & MOD_ALT) != 0;
+        int from = gb.chars + 1; // Sem alteração de texto: só reposiciona o cursor
 
-                // Apaga visualmente (apenas 1 espaço visual para trás, o terminal cuida do resto)
-                renderer_add(r, "\b \b"); 
-                renderer_render(r);
-            }
+        if (ch == KEY_ENTER) break;
+        else if (ch == KEY_BACKSPACE && alt) { gapbuf_delete_word(&gb); from = gb.cursor; }
+        else if (ch == KEY_BACKSPACE) { if (gapbuf_delete_back(&gb)) from = gb.cursor; }
+        else if (ch == KEY_EXT(KEY_DELETE) || ch == 4) { if (gapbuf_delete_fwd(&gb)) from = gb.cursor; }
+        else if (ch == 23) { gapbuf_delete_word(&gb); from = gb.cursor; }                       // Ctrl+W
+        else if (ch == 21) { while (gapbuf_delete_back(&gb)) {} from = 0; }                     // Ctrl+U
+        else if (ch == 11) { while (gapbuf_delete_fwd(&gb)) {} from = gb.cursor; }              // Ctrl+K
+        else if (ch == '\t' && sugestao) {                                                      // Tab: prefixo comum
+            prompt_insert(&gb, cfg->max_chars, sugestao, comum);
+            from = antes;
         }
-        // Aceita qualquer caractere imprimível (acima de espaço)
-        else if (ch >= 32) { 
-            if (visual_len < max_len) {
-                // Converte o Wide Char (ch) para bytes UTF-8
-                char temp_utf8[5] = {0};
-                
-                // Função da API do Windows para converter WCHAR para UTF-8
-                int bytes_written = WideCharToMultiByte(CP_UTF8, 0, (LPCWSTR)&ch, 1, temp_utf8, 4, NULL, NULL);
-                
-                if (bytes_written > 0) {
-                    // Copia os bytes gerados para o buffer principal
-                    memcpy(buffer + current_bytes, temp_utf8, bytes_written);
-                    current_bytes += bytes_written;
-                    buffer[current_bytes] = '\0'; // Garante o fim da string
-                    
-                    visual_len++;
-
-                    // Renderiza o caractere convertido
-                    renderer_add(r, temp_utf8);
-                    renderer_render(r);
-                }
+        else if (ch == KEY_EXT(KEY_RIGHT) && !ctrl && !alt && sugestao) {                       // Aceita a sugestão
+            prompt_insert(&gb, cfg->max_chars, sugestao, strlen(sugestao));
+            from = antes;
+        }
+        else if (ch == KEY_EXT(KEY_LEFT) && !ctrl && !alt) gapbuf_left(&gb);
+        else if (ch == KEY_EXT(KEY_RIGHT) && !ctrl && !alt) gapbuf_right(&gb);
+        else if (ch == KEY_EXT(KEY_LEFT) || (alt && ch == 'b')) gapbuf_word_left(&gb);
+        else if (ch == KEY_EXT(KEY_RIGHT) || (alt && ch == 'f')) gapbuf_word_right(&gb);
+        else if (ch == KEY_EXT(KEY_HOME) || ch == 1) { while (gapbuf_left(&gb)) {} }            // Ctrl+A
+        else if (ch == KEY_EXT(KEY_END) || ch == 5) { while (gapbuf_right(&gb)) {} }            // Ctrl+E
+        else if (h && (ch == KEY_EXT(KEY_UP) || ch == KEY_EXT(KEY_DOWN))) {
+            int alvo = hist_pos + (ch == KEY_EXT(KEY_UP) ? -1 : 1);
+            if (alvo < 0 || alvo > h->count) continue;
+            if (hist_pos == h->count) {
+                free(rascunho);
+                rascunho = gapbuf_to_string(&gb);
             }
+            hist_pos = alvo;
+            gapbuf_set(&gb, hist_pos < h->count ? history_get(h, hist_pos) : (rascunho ? rascunho : ""));
+            from = 0;
+        }
+        else if (h && ch == 18) {                                                               // Ctrl+R
+            buscando = true;
+            consulta_len = 0;
+            consulta[0] = '\0';
+            achado = -1;
+            prompt_paint_text(&v, "(busca)'': ");
+            continue;
+        }
+        else if (ch >= 32 && !KEY_IS_EXT(ch) && !ctrl && !alt) {
+            char temp_utf8[4];
+            int n = tui_utf8_encode((unsigned long)ch, temp_utf8);
+            if (n > 0) prompt_insert(&gb, cfg->max_chars, temp_utf8, n);
+            from = antes;
         }
+        sugestao = prompt_suggest(cfg, &gb, &comum);
+        prompt_repaint(&v, &gb, from, sugestao);
     }
+
+    // Limpa visualmente, reseta cor e cursor
+    renderer_move_cursor(r, y, x);
+    renderer_add_repeat(r, " ", v.drawn);
+    renderer_move_cursor(r, y, x);
+    renderer_add(r, "\033[?2004l");
+    renderer_add(r, "\033[0m");
+    renderer_render(r);
+
+    char* texto = gapbuf_to_string(&gb);
+    gapbuf_free(&gb);
+    free(rascunho);
+    if (h && texto) history_add(h, texto);
+    return texto;
+}
+
+// Prompt simples: campo de max_len colunas aceitando até max_len caracteres
+char* inputs_prompt(Inputs* input, Renderer* r, int x, int y, int max_len, const char* input_color) {
+    if (max_len <= 0) max_len = 255;
+    PromptConfig cfg = { max_len, max_len, input_color, NULL, NULL, NULL, NULL };
+    return inputs_prompt_cfg(input, r, x, y, &cfg);
 }
 
+#endif // TUI_NO_PROMPT
+
+#ifndef TUI_NO_MENUS
 // Menu de seleção vertical navegável com setas
 int inputs_menu_selector_vertical(Inputs* input, Renderer* r, int x, int y, const char** options, int count, const char* bg_normal, const char* fg_normal,const char* bg_select, const char* fg_select,const char* bg_correct, const char* fg_correct) {
     int current_selection = 0;
@@ -774,19 +4408,22 @@ int inputs_menu_selector_vertical(Inputs* input, Renderer* r, int x, int y, cons
         }
 
         // Captura entrada
-        int ch = _getch();
-        if (ch == 0 || ch == 0xE0) {
-            ch = _getch(); // Teclas estendidas
-            if (ch == KEY_UP) {
-                current_selection--;
-                if (current_selection < 0) current_selection = count - 1; // Wrap around
-                redraw = true;
-            } else if (ch == KEY_DOWN) {
-                current_selection++;
-                if (current_selection >= count) current_selection = 0; // Wrap around
-                redraw = true;
-            }
-        } 
+        InputEvent ev;
+        if (inputs_next_event(input, &ev, -1) < 0) {
+            renderer_add(r, "\033[?25h");
+            return -1;
+        }
+        if (ev.type != EV_KEY) continue;
+        int ch = ev.key;
+        if (ch == KEY_EXT(KEY_UP)) {
+            current_selection--;
+            if (current_selection < 0) current_selection = count - 1; // Wrap around
+            redraw = true;
+        } else if (ch == KEY_EXT(KEY_DOWN)) {
+            current_selection++;
+            if (current_selection >= count) current_selection = 0; // Wrap around
+            redraw = true;
+        }
         else if (ch == KEY_ENTER) {
             // Efeito visual de confirmação
             renderer_move_cursor(r, y + current_selection, x);
@@ -803,7 +4440,7 @@ int inputs_menu_selector_vertical(Inputs* input, Renderer* r, int x, int y, cons
             renderer_add(r, "\033[0m");
             renderer_render(r);
             
-            Sleep(150);
+            tui_sleep_ms(150);
             renderer_add(r, "\033[?25h"); // Restaura cursor
             return current_selection;
         }
@@ -853,18 +4490,21 @@ int inputs_menu_selector_horizontal(Inputs* input, Renderer* r, int x, int y, co
             redraw = false;
         }
 
-        int ch = _getch();
-        if (ch == 0 || ch == 0xE0) {
-            ch = _getch();
-            if (ch == KEY_LEFT) {
-                current_selection--;
-                if (current_selection < 0) current_selection = count - 1;
-                redraw = true;
-            } else if (ch == KEY_RIGHT) {
-                current_selection++;
-                if (current_selection >= count) current_selection = 0;
-                redraw = true;
-            }
+        InputEvent ev;
+        if (inputs_next_event(input, &ev, -1) < 0) {
+            renderer_add(r, "\033[?25h");
+            return -1;
+        }
+        if (ev.type != EV_KEY) continue;
+        int ch = ev.key;
+        if (ch == KEY_EXT(KEY_LEFT)) {
+            current_selection--;
+            if (current_selection < 0) current_selection = count - 1;
+            redraw = true;
+        } else if (ch == KEY_EXT(KEY_RIGHT)) {
+            current_selection++;
+            if (current_selection >= count) current_selection = 0;
+            redraw = true;
         }
         else if (ch == KEY_ENTER) {
             // Calcula posição X do item selecionado para desenhar o feedback
@@ -883,7 +4523,7 @@ int inputs_menu_selector_horizontal(Inputs* input, Renderer* r, int x, int y, co
             renderer_add(r, "\033[0m");
             renderer_render(r);
             
-            Sleep(150);
+            tui_sleep_ms(150);
             renderer_add(r, "\033[?25h");
             return current_selection;
         }
@@ -894,19 +4534,229 @@ int inputs_menu_selector_horizontal(Inputs* input, Renderer* r, int x, int y, co
     }
 }
 
-// Captura tecla sem bloquear (non-blocking) ou retorna 0
-int inputs_get_key() {
-    if (_kbhit()) {
-        int ch = _getch();
-        // Normaliza teclas estendidas para range 1000+
-        if (ch == 0 || ch == 0xE0) {
-            return 1000 + _getch(); 
+#endif // TUI_NO_MENUS
+
+// Captura tecla de 'input' sem bloquear ou retorna 0 (estendidas via KEY_EXT)
+int inputs_poll_key(Inputs* input) {
+    InputEvent ev;
+    while (inputs_next_event(input, &ev, 0) == 1) {
+        if (ev.type == EV_KEY) {
+            input->last_key = ev.key;
+            return ev.key;
         }
-        return ch;
     }
     return 0;
 }
 
+// Captura tecla do console do processo sem bloquear (non-blocking) ou retorna 0
+int inputs_get_key() {
+    Inputs* console = inputs_console();
+    return console ? inputs_poll_key(console) : 0;
+}
+
+// Verifica se há entrada no console do processo sem bloquear
+int tui_kbhit(void) {
+    Inputs* console = inputs_console();
+    if (!console) return 0;
+    if (console->len > 0) return 1;
+    inputs_raw_mode(console);
+    return inputs_wait(console, 0);
+}
+
+// Espera uma tecla do console do processo (-1 em fim/erro); passa pelo mesmo leitor
+// de inputs_create, então sequências de escape chegam inteiras
+int tui_getch(void) {
+    Inputs* console = inputs_console();
+    if (!console) return -1;
+    InputEvent ev;
+    while (true) {
+        int res = inputs_next_event(console, &ev, -1);
+        if (res < 0) return -1;
+        if (res == 1 && ev.type == EV_KEY) {
+            console->last_key = ev.key;
+            return ev.key;
+        }
+    }
+}
+
+#if !defined(_WIN32) && !defined(TUI_NO_SERVER)
+// ---------------------------------------------------------------------------
+// Modo servidor: várias sessões (pty/socket) em um único laço de eventos
+// ---------------------------------------------------------------------------
+
+#define SESSION_BUF_INICIAL 4096    // Buffer inicial de saída por sessão
+#define SESSION_BUF_LIMITE  65536   // Acima disto o buffer volta ao inicial após o render
+
+// Coloca o descritor em modo não-bloqueante
+static void tui_set_nonblock(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags >= 0) fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// Cria o servidor com os callbacks de entrada e encerramento
+Server* server_create(SessionInputFn on_input, SessionCloseFn on_close, void* user) {
+    Server* srv = (Server*)calloc(1, sizeof(Server));
+    if (!srv) return NULL;
+    // Um cliente que desconecta não pode derrubar o processo: a escrita falha com
+    // EPIPE e encerra só a sessão dele (se a aplicação não tratou o sinal)
+    struct sigaction atual;
+    if (sigaction(SIGPIPE, NULL, &atual) == 0 && atual.sa_handler == SIG_DFL) signal(SIGPIPE, SIG_IGN);
+    srv->on_input = on_input;
+    srv->on_close = on_close;
+    srv->user = user;
+    return srv;
+}
+
+// Registra uma sessão ligada a fd_in/fd_out (podem ser o mesmo, ex.: pty mestre ou socket)
+Session* server_add(Server* srv, int fd_in, int fd_out, bool owns_fds, void* user) {
+    if (srv->count >= srv->capacity) {
+        size_t nova = srv->capacity ? srv->capacity * 2 : 16;
+        Session** temp = (Session**)realloc(srv->sessions, nova * sizeof(Session*));
+        if (!temp) return NULL;
+        srv->sessions = temp;
+        struct pollfd* tp = (struct pollfd*)realloc(srv->pfds, nova * 2 * sizeof(struct pollfd));
+        if (!tp) return NULL;
+        srv->pfds = tp;
+        srv->capacity = nova;
+    }
+
+    Session* s = (Session*)malloc(sizeof(Session));
+    if (!s) return NULL;
+    s->r = renderer_create_fd(fd_out, SESSION_BUF_INICIAL);
+    s->in = inputs_create_fd(fd_in);
+    if (!s->r || !s->in) {
+        renderer_destroy(s->r);
+        inputs_destroy(s->in);
+        free(s);
+        return NULL;
+    }
+    renderer_set_shrink(s->r, SESSION_BUF_LIMITE);
+    s->user = user;
+    s->closing = false;
+    s->owns_fds = owns_fds;
+
+    tui_set_nonblock(fd_in);
+    if (fd_out != fd_in) tui_set_nonblock(fd_out);
+
+    srv->sessions[srv->count++] = s;
+    return s;
+}
+
+// Marca a sessão para encerramento (efetivado ao fim da iteração atual)
+void server_close(Server* srv, Session* s) {
+    (void)srv;
+    s->closing = true;
+}
+
+// Remove e libera as sessões marcadas
+static void server_reap(Server* srv) {
+    size_t j = 0;
+    for (size_t i = 0; i < srv->count; i++) {
+        Session* s = srv->sessions[i];
+        if (!s->closing) {
+            srv->sessions[j++] = s;
+            continue;
+        }
+        if (srv->on_close) srv->on_close(srv, s, srv->user);
+        if (s->owns_fds) {
+            close(s->in->in);
+            if (s->r->out != s->in->in) close(s->r->out);
+        }
+        renderer_destroy(s->r);
+        inputs_destroy(s->in);
+        free(s);
+    }
+    srv->count = j;
+}
+
+// Executa uma iteração do laço: espera eventos (até timeout_ms), entrega entrada,
+// despeja saídas pendentes. Retorna o número de sessões ativas ou -1 em erro.
+int server_poll(Server* srv, int timeout_ms) {
+    // Monta a lista: entrada sempre, saída só quando há bytes pendentes
+    nfds_t n = 0;
+    for (size_t i = 0; i < srv->count; i++) {
+        Session* s = srv->sessions[i];
+        srv->pfds[n].fd = s->in->in;
+        srv->pfds[n].events = POLLIN;
+        srv->pfds[n].revents = 0;
+        if (s->r->out == s->in->in && renderer_pending(s->r)) {
+            srv->pfds[n].events |= POLLOUT;
+        }
+        n++;
+        if (s->r->out != s->in->in) {
+            srv->pfds[n].fd = s->r->out;
+            srv->pfds[n].events = renderer_pending(s->r) ? POLLOUT : 0;
+            srv->pfds[n].revents = 0;
+            n++;
+        }
+    }
+
+    int pr = poll(srv->pfds, n, timeout_ms);
+    if (pr < 0) return errno == EINTR ? (int)srv->count : -1;
+
+    size_t k = 0;
+    size_t total = srv->count; // Sessões adicionadas em callbacks entram na próxima iteração
+    for (size_t i = 0; i < total; i++) {
+        Session* s = srv->sessions[i];
+        short ev_in = srv->pfds[k].revents;
+        short ev_out = ev_in;
+        k++;
+        if (s->r->out != s->in->in) ev_out = srv->pfds[k++].revents;
+
+        if (ev_in & (POLLIN | POLLHUP | POLLERR)) {
+            int lidos = inputs_read(s->in);
+            if (lidos < 0) {
+                s->closing = true;
+            } else if ((lidos > 0 || s->in->len == INPUTS_BUF_SIZE) && srv->on_input) {
+                srv->on_input(srv, s, srv->user);
+            }
+            if (s->in->error) s->closing = true;
+        }
+        if ((ev_out & POLLOUT) && !s->closing && renderer_render(s->r) < 0) {
+            s->closing = true;
+        }
+    }
+
+    // Despeja o que os callbacks desenharam (sem bloquear)
+    for (size_t i = 0; i < srv->count; i++) {
+        Session* s = srv->sessions[i];
+        if (!s->closing && renderer_pending(s->r) && !s->r->blocked) {
+            if (renderer_render(s->r) < 0) s->closing = true;
+        } else if (!s->closing && !renderer_pending(s->r) && renderer_error(s->r)) {
+            s->closing = true;  // Um render do callback falhou (ex.: EPIPE do cliente que saiu)
+        }
+    }
+
+    server_reap(srv);
+    return (int)srv->count;
+}
+
+// Roda o laço até server_stop ou até não restarem sessões
+void server_run(Server* srv) {
+    srv->running = true;
+    while (srv->running && srv->count > 0) {
+        if (server_poll(srv, -1) < 0) break;
+    }
+    srv->running = false;
+}
+
+// Interrompe server_run ao fim da iteração atual
+void server_stop(Server* srv) {
+    srv->running = false;
+}
+
+// Encerra todas as sessões e libera o servidor
+void server_destroy(Server* srv) {
+    if (!srv) return;
+    for (size_t i = 0; i < srv->count; i++) srv->sessions[i]->closing = true;
+    server_reap(srv);
+    free(srv->sessions);
+    free(srv->pfds);
+    free(srv);
+}
+#endif
+
+#ifndef TUI_NO_COLORS
 // Helper: Escala valor 0-255 para range reduzido de cores ANSI
 static int _scale(int x) {
     if (x < 48) return 0;
@@ -944,16 +4794,48 @@ int color_hex_to_ansi_id(const char* hex) {
     return _rgb_to_ansi256(r, g, b);
 }
 
+// Helper: Índice (0-15) da cor básica mais próxima; 8-15 são as versões claras
+static int _rgb_to_ansi16(int r, int g, int b) {
+    int max = r > g ? (r > b ? r : b) : (g > b ? g : b);
+    if (max < 48) return 0;
+    int lim = max / 2;
+    int id = (r > lim ? 1 : 0) | (g > lim ? 2 : 0) | (b > lim ? 4 : 0);
+    if (id == 7 && max < 160) return 8;   // cinza escuro
+    if (id == 7 && max < 224) return 7;   // cinza claro
+    return max >= 192 ? id + 8 : id;
+}
+
+// Helper: Monta a sequência de cor na maior profundidade que o terminal suporta
+// ('base' = 38 para texto, 48 para fundo)
+static void _color_seq(char* buffer, const char* hex, int base) {
+    int r, g, b;
+    _hex_to_rgb(hex, &r, &g, &b);
+    switch (tui_caps()->color) {
+        case CAP_COLOR_NONE:
+            buffer[0] = '\0';
+            break;
+        case CAP_COLOR_16: {
+            int id = _rgb_to_ansi16(r, g, b);
+            sprintf(buffer, "\033[%dm", (id < 8 ? base - 8 : base + 52) + (id & 7));
+            break;
+        }
+        case CAP_COLOR_TRUE:
+            sprintf(buffer, "\033[%d;2;%d;%d;%dm", base, r, g, b);
+            break;
+        default:
+            sprintf(buffer, "\033[%d;5;%dm", base, _rgb_to_ansi256(r, g, b));
+            break;
+    }
+}
+
 // Gera sequência ANSI de cor de texto (Foreground) no buffer fornecido
 void color_fg(char* buffer, const char* hex) {
-    int ansi_code = color_hex_to_ansi_id(hex);
-    sprintf(buffer, "\033[38;5;%dm", ansi_code);
+    _color_seq(buffer, hex, 38);
 }
 
 // Gera sequência ANSI de cor de fundo (Background) no buffer fornecido
 void color_bg(char* buffer, const char* hex) {
-    int ansi_code = color_hex_to_ansi_id(hex);
-    sprintf(buffer, "\033[48;5;%dm", ansi_code);
+    _color_seq(buffer, hex, 48);
 }
 
 // Wrapper conveniente para color_fg usando buffer estático (retorno direto)
@@ -969,63 +4851,4 @@ char* color_bg_s(const char* hex) {
     color_bg(buffer, hex);
     return buffer;
 }
-
-void teste_1(Renderer* r, Interface* ui, Inputs* inp){
-    // 1. Limpa Tela
-    renderer_add(r, "\033[2J");
-    const char* opcoes[] = {"Novo Jogo","Carregar Jogo","Opcoes","Creditos","Sair"};
-    int quantidade = sizeof(opcoes) / sizeof(opcoes[0]);
-    interface_draw(ui, r, 0, 1, 10, 20, "UI", "", "", "", "");
-    int escolha = inputs_menu_selector_vertical(inp, r, 2, 2, opcoes, quantidade, "", "", "", "", "", "");
-    if (escolha == -1) {
-        interface_text_(ui, r, 2, 12, "O usuario apertou ESC (Cancelou).", "", "");
-    } 
-    else {
-        switch (escolha) {
-            case 0:
-                interface_text_(ui, r, 2, 12, "Iniciando novo jogo...", "", "");
-                break;
-            case 1:
-                interface_text_(ui, r, 2, 12, "Carregando save...", "", "");
-                break;
-            case 4:
-                interface_text_(ui, r, 2, 12, "Saindo do sistema...", "", "");
-                break;
-        }
-    }
-}
-
-void teste_2(Renderer* r, Interface* ui, Inputs* inp){
-    renderer_add(r, "\033[2J");
-    interface_text_(ui, r, 1, 1, "Qual será seu nome?", "", "");
-    interface_text_(ui, r, 1, 2, ">", "", "");
-    char* nome = inputs_prompt(inp, r, 2, 2, 8, "");
-    interface_text_(ui, r, 2, 2, nome, "", "");
-}
-
-void teste_3(Renderer* r, Interface* ui, Inputs* inp){
-    // melhor para loops
-    char cor_fundo[COLOR_STR_SIZE];
-    color_bg(cor_fundo, "#FFFFFF");
-    char cor_texto[COLOR_STR_SIZE];
-    color_fg(cor_texto, "#00FFFF");
-    while (1){
-        interface_draw(ui, r, 1, 1, 10, 20, "ui", "Olá Mundo Colorido",/*Melhor fora de loops*/cor_fundo, color_fg_s("#0000FF"), cor_texto);
-        char* prompt = inputs_prompt(inp, r, 2, 5, 8, (color_fg_s("#00FFFF"),color_bg_s("#FFFFFF")));
-        if (strcmp(prompt, "q") == 0){
-            break;
-        }
-    }
-}
-
-int main(){
-    Renderer* r = renderer_create();
-    Inputs* inp = inputs_create();
-    Interface* ui = interface_create();
-    teste_3(r, ui, inp);
-    renderer_render(r);
-    inputs_destroy(inp);
-    interface_destroy(ui);
-    renderer_destroy(r);
-    return 0;
-}
\ No newline at end of file
+#endif // TUI_NO_COLORS
@@ -0,0 +1,674 @@
+#ifndef C_BIBLIOTECA_H
+#define C_BIBLIOTECA_H
+
+// Biblioteca de interface de texto (TUI) para console do Windows e terminais POSIX.
+//
+// Perfil de compilação: defina antes de incluir (e ao compilar a biblioteca) para
+// remover subsistemas. As mesmas definições devem ser usadas nos dois lados.
+//   TUI_NO_ANIMATION  caixas/textos com digitação animada (interface_*speak)
+//   TUI_NO_MENUS      seletores de menu (inputs_menu_selector_*)
+//   TUI_NO_COLORS     conversão de cores hex (color_*)
+//   TUI_NO_WORDWRAP   quebra por palavras (as linhas passam a ser cortadas na largura)
+//   TUI_NO_PROMPT     editor de linha, histórico e completação (inputs_prompt*)
+//   TUI_NO_WIDGETS    layout retido, tabela e gráficos
+//   TUI_NO_RECORDER   gravação e reprodução de sessões
+//   TUI_NO_THREADS    painéis e montagem paralela de quadros (sem pthread)
+//   TUI_NO_SERVER     laço de várias sessões (POSIX)
+//   TUI_NO_LINES      modo de linhas para saídas que não são terminais
+//   TUI_MINIMAL       todos os anteriores
+
+#ifdef TUI_MINIMAL
+#define TUI_NO_ANIMATION
+#define TUI_NO_MENUS
+#define TUI_NO_COLORS
+#define TUI_NO_WORDWRAP
+#define TUI_NO_PROMPT
+#define TUI_NO_WIDGETS
+#define TUI_NO_RECORDER
+#define TUI_NO_THREADS
+#define TUI_NO_SERVER
+#define TUI_NO_LINES
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+
+typedef HANDLE tui_fd;              // Destino/origem de E/S (console, pipe, arquivo)
+#define TUI_FD_INVALID INVALID_HANDLE_VALUE
+#else
+typedef int tui_fd;                 // Descritor de arquivo (terminal, pty, socket)
+#define TUI_FD_INVALID (-1)
+#endif
+
+#ifndef TUI_NO_THREADS
+#include <stdatomic.h>
+#ifdef _WIN32
+typedef HANDLE tui_thread;
+typedef CRITICAL_SECTION tui_mutex;
+typedef CONDITION_VARIABLE tui_cond;
+#else
+#include <pthread.h>
+typedef pthread_t tui_thread;
+typedef pthread_mutex_t tui_mutex;
+typedef pthread_cond_t tui_cond;
+#endif
+#endif
+
+#define COLOR_STR_SIZE 20 
+#define C_RESET "\033[0m"
+#define C_BOLD  "\033[1m"
+
+// Códigos de tecla
+#define KEY_ENTER 13
+#define KEY_BACKSPACE 8
+#define KEY_ESC 27
+#define KEY_UP 72
+#define KEY_DOWN 80
+#define KEY_LEFT 75
+#define KEY_RIGHT 77
+#define KEY_HOME 71
+#define KEY_END 79
+#define KEY_PGUP 73
+#define KEY_PGDN 81
+#define KEY_INSERT 82
+#define KEY_DELETE 83
+#define KEY_F1 59   // F1..F10 são consecutivos
+#define KEY_F11 133
+#define KEY_F12 134
+
+// Teclas estendidas normalizadas acima do último ponto de código Unicode
+// (ex.: KEY_EXT(KEY_UP)), para não colidirem com caracteres digitados
+#define KEY_EXT(k) (0x110000 + (k))
+#define KEY_IS_EXT(c) ((c) >= KEY_EXT(0))
+
+// ---------------------------------------------------------------------------
+// Plataforma
+// ---------------------------------------------------------------------------
+
+void tui_sleep_ms(unsigned ms);
+uint64_t tui_now_us(void);
+int tui_kbhit(void);
+int tui_getch(void);
+void tui_restore(void);
+int tui_utf8_encode(unsigned long cp, char* out);
+bool tui_terminal_size(tui_fd fd, int* rows, int* cols);
+
+// Profundidade de cor suportada
+#define CAP_COLOR_NONE 0
+#define CAP_COLOR_16   1
+#define CAP_COLOR_256  2
+#define CAP_COLOR_TRUE 3
+
+// Capacidades do terminal
+typedef struct {
+    int color;      // CAP_COLOR_*
+    bool sync;      // Atualização sincronizada (CSI ?2026h/l): quadro aparece de uma vez
+    bool rep;       // CSI n b repete o último caractere
+    bool is_tty;    // A saída padrão é um terminal
+} TermCaps;
+
+const TermCaps* tui_caps(void);
+void tui_caps_set(const TermCaps* caps);
+
+// ---------------------------------------------------------------------------
+// Renderer
+// ---------------------------------------------------------------------------
+
+typedef struct Recorder Recorder;
+typedef struct LineGrid LineGrid;
+typedef struct Renderer Renderer;
+
+// Desenha o quadro inteiro sob demanda do governador (ver renderer_set_frame)
+typedef void (*RendererFrameFn)(Renderer* r, void* user);
+
+// Trecho de saída: referência a dados externos ou faixa do buffer próprio
+typedef struct {
+    const char* ref;    // Dados do chamador (NULL = faixa do buffer próprio)
+    size_t offset;      // Início da faixa no buffer próprio (quando ref == NULL)
+    size_t len;         // Tamanho do trecho em bytes
+} RendererSeg;
+
+struct Renderer {
+    char* buffer;       // Buffer principal de saída
+    size_t capacity;    // Capacidade total alocada
+    size_t size;        // Bytes usados atualmente
+    tui_fd out;         // Destino da saída (console, pty, socket...)
+    bool blocked;       // Último render parou por saída não-bloqueante cheia
+
+    // Modo zero-copy: lista de trechos despejada em ordem no render
+    RendererSeg* segs;  // Trechos pendentes (vazio = apenas o buffer)
+    size_t seg_count;   // Trechos em uso
+    size_t seg_capacity;// Trechos alocados
+    size_t seg_start;   // Início da faixa do buffer ainda não registrada
+    bool zero_copy;     // Registra dados imutáveis por referência
+    size_t zc_min;      // Tamanho mínimo para referenciar em vez de copiar
+
+    // Política de memória do buffer
+    size_t initial_capacity;  // Capacidade inicial (alvo da redução)
+    size_t max_capacity;      // Limite de crescimento (0 = sem limite)
+    size_t shrink_high_water; // Reduz após o render se passar disto (0 = nunca)
+    bool auto_flush;          // Despeja ao encher em vez de crescer
+    bool error;               // Alguma adição falhou desde o último render
+    Recorder* rec;            // Gravação da saída (NULL = desligada)
+
+    const TermCaps* caps;     // Capacidades da saída (NULL = só sequências básicas)
+    bool caps_auto;           // Detecta as do terminal do processo no primeiro uso
+    bool in_frame;            // Quadro aberto desde o último render
+    bool setup_console;       // Configurar o console (UTF-8) no primeiro render
+    LineGrid* lines;          // Modo de linhas (NULL = saída vai direto para 'out')
+
+    // Governador de quadros: pedidos de redesenho viram no máximo um despejo por intervalo
+    RendererFrameFn frame_fn; // Desenha o quadro (NULL = despeja o que já está no buffer)
+    void* frame_user;
+    bool dirty;               // Há pedido de redesenho pendente
+    uint64_t frame_last;      // Instante (µs) do último despejo do governador
+    uint64_t frame_min;       // Intervalo mínimo entre despejos (µs)
+    uint64_t frame_max;       // Intervalo máximo, sob saída lenta (µs)
+    uint64_t frame_interval;  // Intervalo atual, adaptado à latência de escrita
+    uint64_t write_avg;       // Média móvel da duração de um despejo (µs)
+};
+
+Renderer* renderer_create_fd(tui_fd out, size_t initial_capacity);
+Renderer* renderer_create_ex(size_t initial_capacity);
+Renderer* renderer_create();
+#ifndef TUI_NO_LINES
+Renderer* renderer_create_lines(tui_fd out, int width, int max_rows, bool sgr);
+int renderer_lines_flush(Renderer* r, int y);
+#endif
+void renderer_destroy(Renderer* r);
+void renderer_set_limits(Renderer* r, size_t max_capacity, bool auto_flush);
+void renderer_set_shrink(Renderer* r, size_t high_water);
+void renderer_set_caps(Renderer* r, const TermCaps* caps);
+bool renderer_error(const Renderer* r);
+int renderer_render(Renderer* r);
+bool renderer_pending(const Renderer* r);
+void renderer_set_frame(Renderer* r, RendererFrameFn fn, void* user, int min_ms, int max_ms);
+void renderer_invalidate(Renderer* r);
+int renderer_tick(Renderer* r);
+int renderer_add_raw(Renderer* r, const char* dados, size_t tamanho);
+int renderer_add(Renderer* r, const char* content);
+void renderer_set_zero_copy(Renderer* r, bool ativo, size_t min_len);
+int renderer_add_ref_raw(Renderer* r, const char* dados, size_t tamanho);
+int renderer_add_ref(Renderer* r, const char* content);
+void renderer_add_repeat(Renderer* r, const char* glyph, int count);
+void renderer_move_cursor(Renderer* r, int y, int x);
+void renderer_discard(Renderer* r);
+int renderer_append(Renderer* dst, const Renderer* src);
+
+#ifndef TUI_NO_THREADS
+// ---------------------------------------------------------------------------
+// Painéis e montagem paralela de quadros
+// ---------------------------------------------------------------------------
+
+// Região da tela com buffer triplo. Uma única thread produtora desenha e publica;
+// a thread de render coleta o quadro mais recente sem travas (o último publicado vence).
+typedef struct {
+    Renderer* bufs[3];  // Buffers: produtor, publicado e consumidor (índices rotativos)
+    int back;           // Buffer do produtor (só a thread produtora acessa)
+    int front;          // Buffer do consumidor (só a thread de render acessa)
+    atomic_int ready;   // Buffer publicado | PANEL_NOVO
+} RenderPanel;
+
+RenderPanel* panel_create(size_t initial_capacity);
+void panel_destroy(RenderPanel* p);
+Renderer* panel_begin(RenderPanel* p);
+void panel_submit(RenderPanel* p);
+bool panel_collect(RenderPanel* p, Renderer* dst);
+int renderer_collect_panels(Renderer* dst, RenderPanel** panels, size_t count);
+
+// Desenha as linhas [y0, y1] (inclusive, base 1) da faixa no buffer 'r'
+typedef void (*FrameBandFn)(Renderer* r, int y0, int y1, void* user);
+
+typedef struct {
+    Renderer* cur;      // Saída da faixa neste quadro
+    Renderer* prev;     // Saída da faixa no quadro anterior (para comparação)
+    bool changed;       // Difere do quadro anterior
+} FrameBand;
+
+typedef struct {
+    tui_thread* threads;    // Threads auxiliares (a thread chamadora também trabalha)
+    int n_threads;
+    tui_mutex lock;
+    tui_cond cond_work;     // Sinaliza novo quadro aos auxiliares
+    tui_cond cond_done;     // Sinaliza o fim do quadro à thread chamadora
+    unsigned generation;    // Número do quadro atual
+    int active;             // Auxiliares ainda dentro do quadro atual
+    int acked;              // Auxiliares que já acordaram para o quadro atual
+    bool quit;
+
+    FrameBand* bands;       // Faixas do layout atual
+    int band_count;
+    int band_rows;          // Linhas por faixa
+    int rows;               // Altura total da tela
+    bool invalid;           // Força redesenho completo no próximo quadro
+    FrameBandFn fn;
+    void* user;
+    atomic_int next_job;    // Próxima faixa a ser pega
+    atomic_int done;        // Faixas concluídas
+} FramePool;
+
+FramePool* framepool_create(int threads);
+void framepool_destroy(FramePool* pool);
+void framepool_invalidate(FramePool* pool);
+int frame_build_parallel(FramePool* pool, Renderer* r, int rows, int band_rows, FrameBandFn fn, void* user);
+#endif
+
+// ---------------------------------------------------------------------------
+// Interface
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const char* B_RESET;
+    const char* B_SPACE;
+} Interface;
+
+Interface* interface_create();
+void interface_destroy(Interface* i);
+int interface_visible_len(const char* s);
+void interface_move_cursor(Renderer* r, int y, int x);
+char** simple_word_wrap(const char* text, int width, int* num_lines);
+void free_wrapped_lines(char** lines, int count);
+void interface_clear(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* bg_color);
+void interface_draw_lines(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* title, char** lines, int num_lines, const char* bg_color, const char* border_color, const char* text_color);
+void interface_draw(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* title, const char* text_line, const char* bg_color, const char* border_color, const char* text_color);
+int get_utf8_char_len(unsigned char c);
+void interface_drawline(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* title, const char* text_line, const char* bg_color, const char* border_color, const char* text_color, const char* border_style);
+void interface_text_(Interface* ui, Renderer* r, int x, int y, const char* texto, const char* text_color, const char* bg_color);
+#ifndef TUI_NO_ANIMATION
+void interface_drawspeak(Interface* ui, Renderer* r, int x, int y, int height, int width, const char* title, const char* texto, const char* bg_color, const char* border_color, const char* text_color, float speed);
+void interface_text_speak(Interface* ui, Renderer* r, int x, int y, const char* texto, const char* bg_color, const char* text_color, float speed);
+#endif
+
+#ifndef TUI_NO_WIDGETS
+// ---------------------------------------------------------------------------
+// Layout retido, tabela e gráficos
+// ---------------------------------------------------------------------------
+
+// Coordenada >= 0 é absoluta (0 = primeira célula), -1..-999 conta a partir do fim
+// (em largura/altura, -1 estende até a borda) e LAYOUT_PCT(p) é p% do terminal.
+// O desenho recebe posições de tela (base 1)
+#define LAYOUT_PCT(p) (-1000 - (p))
+
+typedef void (*LayoutDrawFn)(Renderer* r, int x, int y, int height, int width, void* user);
+
+typedef struct {
+    int x, y, w, h;             // Especificação (ver LAYOUT_PCT)
+    int rx, ry, rw, rh;         // Retângulo resolvido para o tamanho atual
+    bool dirty;                 // Precisa ser redesenhado
+    char* title;
+    char* text;                 // Cópia própria do texto
+    char** lines;               // Texto quebrado em cache
+    int num_lines;
+    int wrap_width;             // Largura usada na última quebra (-1 = nenhuma)
+    const char* bg_color;
+    const char* border_color;
+    const char* text_color;
+    LayoutDrawFn draw;          // Desenho próprio (NULL = caixa com texto)
+    void* user;
+} LayoutItem;
+
+typedef struct {
+    Interface* ui;
+    LayoutItem* items;
+    int count;
+    int capacity;
+    int rows, cols;             // Tamanho atual do terminal
+} Layout;
+
+Layout* layout_create(Interface* ui, int rows, int cols);
+void layout_destroy(Layout* l);
+int layout_add_box(Layout* l, int x, int y, int w, int h, const char* title, const char* text, const char* bg_color, const char* border_color, const char* text_color);
+int layout_add_custom(Layout* l, int x, int y, int w, int h, LayoutDrawFn fn, void* user);
+int layout_set_text(Layout* l, int id, const char* text);
+void layout_invalidate(Layout* l, int id);
+void layout_resize(Layout* l, Renderer* r, int rows, int cols);
+void layout_draw(Layout* l, Renderer* r);
+
+#define TABLE_LEFT 0
+#define TABLE_RIGHT 1
+
+typedef struct {
+    char* title;
+    int width;          // Largura atual em colunas de tela
+    int max_width;      // Limite da largura automática
+    bool auto_width;    // Cresce com o conteúdo até max_width
+    int align;          // TABLE_LEFT ou TABLE_RIGHT
+} TableColumn;
+
+typedef struct {
+    TableColumn* cols;
+    int ncols;
+    char** cells;       // rows * ncols textos (NULL = vazio)
+    unsigned char* flags;   // TABLE_ROW_* por linha
+    double* keys;           // Valor numérico da coluna de ordenação, por linha
+    int rows;
+    int capacity;
+
+    // Visão ordenada: linhas alteradas na coluna de ordenação são reinseridas em lote
+    int* order;         // Posição na visão -> linha
+    int ordered;        // Linhas presentes em 'order'
+    int* tmp;           // Área de trabalho da reinserção
+    int* pending;       // Linhas aguardando reinserção
+    int pending_count;
+    int sort_col;       // Coluna de ordenação (-1 = ordem de inserção)
+    bool sort_desc;
+
+    // Janela visível
+    int x, y;           // Canto superior esquerdo (base 1, como interface_move_cursor)
+    int height, width;  // Linhas (incluindo o cabeçalho) e colunas de tela
+    int top;            // Primeira posição da visão exibida
+    int first_col;      // Primeira coluna exibida
+    int* drawn;         // Linha desenhada em cada linha da janela (-3 = redesenhar)
+    bool header_dirty;
+    const char* header_color;
+    const char* text_color;
+} Table;
+
+Table* table_create(int ncols);
+void table_destroy(Table* t);
+void table_invalidate(Table* t);
+void table_set_column(Table* t, int col, const char* title, int width, int max_width, int align);
+void table_set_view(Table* t, int x, int y, int height, int width);
+void table_scroll(Table* t, int top, int first_col);
+void table_set_colors(Table* t, const char* header_color, const char* text_color);
+int table_append(Table* t, const char* const* cells);
+int table_set_cell(Table* t, int row, int col, const char* text);
+const char* table_get_cell(const Table* t, int row, int col);
+int table_row_count(const Table* t);
+int table_row_at(Table* t, int p);
+void table_sort(Table* t, int col, bool descending);
+void table_draw(Table* t, Renderer* r);
+
+// Buffer circular de amostras: inserir é O(1) e descarta a mais antiga quando cheio
+typedef struct {
+    double* data;
+    int capacity;
+    int head;           // Próxima posição de escrita
+    int count;          // Amostras válidas (<= capacity)
+} Series;
+
+Series* series_create(int capacity);
+void series_destroy(Series* s);
+void series_push(Series* s, double v);
+double series_at(const Series* s, int i);
+
+// Gráfico de barras verticais sobre uma série: altura 1 é uma sparkline
+typedef struct {
+    const Series* series;
+    int x, y;           // Canto superior esquerdo (base 1)
+    int width, height;  // Em células
+    int bar_width;      // Células por barra
+    int gap;            // Células entre barras
+    double min, max;    // Escala fixa (min == max = automática pelas amostras visíveis)
+    const char* color;
+    unsigned char* shown;   // Nível exibido em cada célula (width * height)
+    unsigned char* next;    // Área de trabalho de uma linha
+} Chart;
+
+Chart* chart_create(const Series* s, int x, int y, int width, int height);
+void chart_destroy(Chart* c);
+void chart_invalidate(Chart* c);
+void chart_set_range(Chart* c, double min, double max);
+void chart_set_bars(Chart* c, int bar_width, int gap);
+void chart_set_color(Chart* c, const char* color);
+void chart_draw(Chart* c, Renderer* r);
+
+// Medidor horizontal: barra proporcional ao valor com resolução de 1/8 de célula
+typedef struct {
+    int x, y, width;
+    double min, max;
+    double value;
+    const char* color;
+    unsigned char* shown;
+    unsigned char* next;
+} Gauge;
+
+Gauge* gauge_create(int x, int y, int width, double min, double max);
+void gauge_destroy(Gauge* g);
+void gauge_invalidate(Gauge* g);
+void gauge_set_color(Gauge* g, const char* color);
+void gauge_set(Gauge* g, double v);
+void gauge_draw(Gauge* g, Renderer* r);
+#endif
+
+// ---------------------------------------------------------------------------
+// Entrada
+// ---------------------------------------------------------------------------
+
+#define INPUTS_BUF_SIZE 1024
+#define INPUTS_PASTE_MAX (1024 * 1024) // Colagens maiores chegam em vários EV_PASTE
+
+// Tipos de evento de entrada
+#define EV_NONE  0
+#define EV_KEY   1  // Tecla: ponto de código Unicode, código de controle ou KEY_EXT(...)
+#define EV_PASTE 2  // Bloco colado (bracketed paste) em paste/paste_len
+#define EV_RESIZE 3 // Terminal redimensionado para rows x cols
+
+// Modificadores (mesmos bits do xterm)
+#define MOD_SHIFT 1
+#define MOD_ALT   2
+#define MOD_CTRL  4
+
+typedef struct {
+    int type;           // EV_*
+    int key;            // Tecla (EV_KEY)
+    int mods;           // MOD_* combinados
+    const char* paste;  // Texto colado (EV_PASTE), válido até o próximo evento
+    size_t paste_len;   // Bytes colados
+    int rows, cols;     // Novo tamanho (EV_RESIZE)
+} InputEvent;
+
+typedef struct {
+    int last_key;
+    tui_fd in;                          // Origem dos bytes (console, pty, socket)
+    size_t len;                         // Bytes lidos e ainda não consumidos
+    unsigned char buf[INPUTS_BUF_SIZE]; // Bytes recebidos
+    bool raw_set;                       // Modo bruto já configurado na origem
+    bool pasting;                       // Dentro de ESC[200~ ... ESC[201~
+    char* paste;                        // Bloco colado em montagem
+    size_t paste_len;
+    size_t paste_cap;
+    bool paste_split;                   // Parte do bloco já entregue; o próximo EV_PASTE recomeça
+    bool error;                         // Falha de alocação ao montar a colagem
+    bool watch_resize;                  // Gera EV_RESIZE quando o terminal muda de tamanho
+    tui_fd size_fd;                     // Terminal consultado para o tamanho
+    int rows, cols;                     // Último tamanho conhecido
+    int winch_seen;                     // Último SIGWINCH tratado
+    Recorder* rec;                      // Gravação dos eventos (NULL = desligada)
+    int refs;                           // Referências ao leitor do console (ver inputs_create)
+} Inputs;
+
+Inputs* inputs_create_fd(tui_fd in);
+Inputs* inputs_create();
+Inputs* inputs_console(void);
+void inputs_console_destroy(void);
+int inputs_read(Inputs* input);
+void inputs_consume(Inputs* input, size_t n);
+bool inputs_decode(Inputs* input, InputEvent* ev, bool flush);
+bool inputs_watch_resize(Inputs* input, tui_fd term, int* rows, int* cols);
+int inputs_next_event(Inputs* input, InputEvent* ev, int timeout_ms);
+void inputs_destroy(Inputs* input);
+int inputs_visible_len(const char* s);
+bool is_utf8_continuation(char c);
+int inputs_poll_key(Inputs* input);
+int inputs_get_key();
+#ifndef TUI_NO_MENUS
+int inputs_menu_selector_vertical(Inputs* input, Renderer* r, int x, int y, const char** options, int count, const char* bg_normal, const char* fg_normal,const char* bg_select, const char* fg_select,const char* bg_correct, const char* fg_correct);
+int inputs_menu_selector_horizontal(Inputs* input, Renderer* r, int x, int y, const char** options, int count, const char* bg_normal, const char* fg_normal,const char* bg_select, const char* fg_select,const char* bg_correct, const char* fg_correct);
+#endif
+
+#ifndef TUI_NO_RECORDER
+// ---------------------------------------------------------------------------
+// Gravação e reprodução de sessões
+// ---------------------------------------------------------------------------
+
+#define REC_FRAME 1     // Bytes escritos por um renderer_render
+#define REC_INPUT 2     // Tecla: key (varint zigzag), mods (1 byte)
+#define REC_RESIZE 3    // Novo tamanho: rows, cols (varint)
+#define REC_PASTE 4     // Colagem: mods (1 byte) e os bytes colados
+
+struct Recorder {
+    FILE* f;
+    uint64_t last_us;   // Instante do último registro
+    char* frame;        // Saída do render em andamento
+    size_t frame_len;
+    size_t frame_cap;
+    bool error;         // Falha de escrita/alocação (gravação interrompida)
+};
+
+Recorder* recorder_create(const char* path);
+void recorder_write(Recorder* rec, int type, const void* data, size_t len);
+void recorder_input(Recorder* rec, const InputEvent* ev);
+void recorder_destroy(Recorder* rec);
+void renderer_set_recorder(Renderer* r, Recorder* rec);
+void inputs_set_recorder(Inputs* input, Recorder* rec);
+
+// Registro lido de uma gravação
+typedef struct {
+    int type;           // REC_FRAME, REC_INPUT, REC_RESIZE, REC_PASTE ou outro (desconhecido)
+    uint64_t time_us;   // Instante desde o início da gravação
+    const char* data;   // Conteúdo bruto (válido até a próxima leitura)
+    size_t len;
+    InputEvent ev;      // Evento decodificado (REC_INPUT / REC_RESIZE / REC_PASTE)
+} ReplayRecord;
+
+typedef struct {
+    FILE* f;
+    int version;        // Versão do formato do arquivo
+    uint64_t time_us;   // Instante acumulado do último registro
+    char* data;
+    size_t cap;
+} Replayer;
+
+// Chamado para cada evento de entrada durante a reprodução
+typedef void (*ReplayInputFn)(const InputEvent* ev, void* user);
+
+Replayer* replayer_open(const char* path);
+int replayer_next(Replayer* rp, ReplayRecord* out);
+long replayer_play(Replayer* rp, Renderer* r, double speed, ReplayInputFn on_input, void* user);
+void replayer_close(Replayer* rp);
+#endif
+
+#ifndef TUI_NO_PROMPT
+// ---------------------------------------------------------------------------
+// Prompt de linha, histórico e completação
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    char** items;   // Entradas em anel: a i-ésima mais antiga é history_get(h, i)
+    int head;       // Posição da mais antiga em items
+    int count;
+    int max;        // Limite de entradas mantidas
+    char* path;     // Arquivo de persistência (NULL = só memória)
+} History;
+
+History* history_create(int max_entries);
+void history_destroy(History* h);
+int history_save(const History* h, const char* path);
+int history_load(History* h, const char* path);
+void history_add(History* h, const char* line);
+const char* history_get(const History* h, int i);
+
+#define COMPLETER_BLOCO 65536
+
+typedef struct CompleterBlock {
+    struct CompleterBlock* next;
+    size_t used;
+    char data[COMPLETER_BLOCO];
+} CompleterBlock;
+
+typedef struct {
+    char** items;           // Candidatos (ordenados após completer_build)
+    size_t count;
+    size_t capacity;
+    bool sorted;
+    CompleterBlock* blocks; // Armazenamento das strings
+} Completer;
+
+Completer* completer_create(void);
+void completer_destroy(Completer* c);
+int completer_add(Completer* c, const char* item);
+void completer_build(Completer* c);
+size_t completer_find(Completer* c, const char* prefix, size_t len, size_t* first);
+const char* completer_get(const Completer* c, size_t i);
+
+// Hook de completação do prompt: devolve o primeiro candidato e o tamanho do prefixo
+// comum a todos (em um vetor ordenado, é o prefixo comum do primeiro e do último)
+typedef bool (*PromptCompleteFn)(const char* prefix, size_t len, const char** match, size_t* common, void* user);
+
+bool completer_prompt_hook(const char* prefix, size_t len, const char** match, size_t* common, void* user);
+
+// Configuração do prompt de linha
+typedef struct {
+    int width;              // Colunas visíveis do campo (rola horizontalmente se o texto for maior)
+    int max_chars;          // Limite de caracteres (0 = ilimitado)
+    const char* color;      // Sequência de cor do texto
+    const char* initial;    // Texto inicial (opcional)
+    History* history;       // Histórico (setas/Ctrl+R; Enter acrescenta) ou NULL
+    PromptCompleteFn complete; // Completação da palavra sob o cursor (Tab/seta direita) ou NULL
+    void* complete_user;    // Dados do hook (ex.: Completer*)
+} PromptConfig;
+
+char* inputs_prompt_cfg(Inputs* input, Renderer* r, int x, int y, const PromptConfig* cfg);
+char* inputs_prompt(Inputs* input, Renderer* r, int x, int y, int max_len, const char* input_color);
+#endif
+
+#if !defined(_WIN32) && !defined(TUI_NO_SERVER)
+// ---------------------------------------------------------------------------
+// Modo servidor: várias sessões (pty/socket) em um único laço de eventos
+// ---------------------------------------------------------------------------
+
+typedef struct Session Session;
+typedef struct Server Server;
+
+// Chamado com os bytes recebidos da sessão (já no buffer de s->in)
+typedef void (*SessionInputFn)(Server* srv, Session* s, void* user);
+// Chamado quando a sessão termina (fim de arquivo, erro ou server_close)
+typedef void (*SessionCloseFn)(Server* srv, Session* s, void* user);
+
+struct Session {
+    Renderer* r;        // Saída da sessão
+    Inputs* in;         // Entrada da sessão
+    void* user;         // Dados do chamador para esta sessão
+    bool closing;       // Marcada para remoção ao fim da iteração
+    bool owns_fds;      // Fecha os descritores ao remover
+};
+
+struct Server {
+    Session** sessions;     // Sessões ativas
+    struct pollfd* pfds;    // Descritores preparados para poll (2 por sessão)
+    size_t count;           // Sessões em uso
+    size_t capacity;        // Sessões alocadas
+    SessionInputFn on_input;
+    SessionCloseFn on_close;
+    void* user;
+    bool running;
+};
+
+Server* server_create(SessionInputFn on_input, SessionCloseFn on_close, void* user);
+Session* server_add(Server* srv, int fd_in, int fd_out, bool owns_fds, void* user);
+void server_close(Server* srv, Session* s);
+int server_poll(Server* srv, int timeout_ms);
+void server_run(Server* srv);
+void server_stop(Server* srv);
+void server_destroy(Server* srv);
+#endif
+
+#ifndef TUI_NO_COLORS
+// ---------------------------------------------------------------------------
+// Cores
+// ---------------------------------------------------------------------------
+
+int color_hex_to_ansi_id(const char* hex);
+void color_fg(char* buffer, const char* hex);
+void color_bg(char* buffer, const char* hex);
+char* color_fg_s(const char* hex);
+char* color_bg_s(const char* hex);
+#endif
+
+#endif
@@ -0,0 +1,90 @@
+#include <string.h>
+
+#include "C_biblioteca.h"
+
+// Os testes só usam o que o perfil de compilação (TUI_NO_*) mantém
+
+#ifndef TUI_NO_MENUS
+void teste_1(Renderer* r, Interface* ui, Inputs* inp){
+    // 1. Limpa Tela
+    renderer_add(r, "\033[2J");
+    const char* opcoes[] = {"Novo Jogo","Carregar Jogo","Opcoes","Creditos","Sair"};
+    int quantidade = sizeof(opcoes) / sizeof(opcoes[0]);
+    interface_draw(ui, r, 0, 1, 10, 20, "UI", "", "", "", "");
+    int escolha = inputs_menu_selector_vertical(inp, r, 2, 2, opcoes, quantidade, "", "", "", "", "", "");
+    if (escolha == -1) {
+        interface_text_(ui, r, 2, 12, "O usuario apertou ESC (Cancelou).", "", "");
+    } 
+    else {
+        switch (escolha) {
+            case 0:
+                interface_text_(ui, r, 2, 12, "Iniciando novo jogo...", "", "");
+                break;
+            case 1:
+                interface_text_(ui, r, 2, 12, "Carregando save...", "", "");
+                break;
+            case 4:
+                interface_text_(ui, r, 2, 12, "Saindo do sistema...", "", "");
+                break;
+        }
+    }
+}
+#endif
+
+#ifndef TUI_NO_PROMPT
+void teste_2(Renderer* r, Interface* ui, Inputs* inp){
+    renderer_add(r, "\033[2J");
+    interface_text_(ui, r, 1, 1, "Qual será seu nome?", "", "");
+    interface_text_(ui, r, 1, 2, ">", "", "");
+    char* nome = inputs_prompt(inp, r, 2, 2, 8, "");
+    interface_text_(ui, r, 2, 2, nome, "", "");
+}
+#endif
+
+void teste_3(Renderer* r, Interface* ui, Inputs* inp){
+    // melhor para loops
+#ifndef TUI_NO_COLORS
+    char cor_fundo[COLOR_STR_SIZE];
+    color_bg(cor_fundo, "#FFFFFF");
+    char cor_texto[COLOR_STR_SIZE];
+    color_fg(cor_texto, "#00FFFF");
+#else
+    const char* cor_fundo = "";
+    const char* cor_texto = C_BOLD;
+#endif
+    while (1){
+#ifndef TUI_NO_COLORS
+        interface_draw(ui, r, 1, 1, 10, 20, "ui", "Olá Mundo Colorido",/*Melhor fora de loops*/cor_fundo, color_fg_s("#0000FF"), cor_texto);
+#else
+        interface_draw(ui, r, 1, 1, 10, 20, "ui", "Olá Mundo", cor_fundo, "", cor_texto);
+#endif
+#ifndef TUI_NO_PROMPT
+#ifndef TUI_NO_COLORS
+        char* prompt = inputs_prompt(inp, r, 2, 5, 8, (color_fg_s("#00FFFF"),color_bg_s("#FFFFFF")));
+#else
+        char* prompt = inputs_prompt(inp, r, 2, 5, 8, "");
+#endif
+        if (strcmp(prompt, "q") == 0){
+            break;
+        }
+#else
+        // Sem editor de linha: sai com a tecla q
+        renderer_render(r);
+        InputEvent ev;
+        if (inputs_next_event(inp, &ev, -1) < 0) break;
+        if (ev.type == EV_KEY && ev.key == 'q') break;
+#endif
+    }
+}
+
+int main(){
+    Renderer* r = renderer_create();
+    Inputs* inp = inputs_create();
+    Interface* ui = interface_create();
+    teste_3(r, ui, inp);
+    renderer_render(r);
+    inputs_destroy(inp);
+    interface_destroy(ui);
+    renderer_destroy(r);
+    return 0;
+}
\ No newline at end of file
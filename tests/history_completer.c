@@ -0,0 +1,170 @@
+// Histórico (anel com limite, carga/gravação, navegação e busca reversa no prompt)
+// e índice de completação (busca por prefixo e hook de Tab/seta direita).
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "C_biblioteca.h"
+
+#if defined(_WIN32) || defined(TUI_NO_PROMPT)
+int main(void) {
+    puts("history_completer: prompt desligado (TUI_NO_PROMPT) ou sem pipes POSIX");
+    return 0;
+}
+#else
+#include <fcntl.h>
+#include <unistd.h>
+
+static int falhas = 0;
+
+#define CONFERE(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); falhas++; } \
+} while (0)
+
+#define CIMA   "\033[A"
+#define BAIXO  "\033[B"
+#define DIR    "\033[C"
+#define CTRL_R "\022"
+
+static int fds[2];
+static Inputs* in;
+static Renderer* r;
+
+// Digita 'teclas' no prompt e confere a linha devolvida
+static void confere_linha(const PromptConfig* cfg, const char* teclas, const char* esperado, int linha) {
+    size_t n = strlen(teclas);
+    if (write(fds[1], teclas, n) != (ssize_t)n) exit(1);
+    char* obtido = inputs_prompt_cfg(in, r, 1, 1, cfg);
+    if (!obtido || strcmp(obtido, esperado) != 0) {
+        fprintf(stderr, "%s:%d: obtido '%s', esperado '%s'\n", __FILE__, linha, obtido ? obtido : "(null)", esperado);
+        falhas++;
+    }
+    in->len = 0;
+    free(obtido);
+}
+
+#define LINHA(cfg, teclas, esperado) confere_linha(cfg, teclas, esperado, __LINE__)
+
+// Confere as entradas do histórico, da mais antiga para a mais recente
+static void confere_historico(const History* h, const char* const* esperado, int n, int linha) {
+    bool ok = h->count == n;
+    for (int i = 0; ok && i < n; i++) ok = strcmp(history_get(h, i), esperado[i]) == 0;
+    if (!ok) {
+        fprintf(stderr, "%s:%d: histórico diferente (%d entradas):", __FILE__, linha, h->count);
+        for (int i = 0; i < h->count; i++) fprintf(stderr, " '%s'", history_get(h, i));
+        fputc('\n', stderr);
+        falhas++;
+    }
+}
+
+#define HISTORICO(h, ...) do { \
+    const char* esperado_[] = { __VA_ARGS__ }; \
+    confere_historico(h, esperado_, (int)(sizeof(esperado_) / sizeof(esperado_[0])), __LINE__); \
+} while (0)
+
+// Histórico novo com três entradas, ligado ao prompt
+static History* historico_base(PromptConfig* cfg) {
+    if (cfg->history) history_destroy(cfg->history);
+    History* h = history_create(10);
+    history_add(h, "ls");
+    history_add(h, "make test");
+    history_add(h, "git status");
+    cfg->history = h;
+    return h;
+}
+
+int main(void) {
+    const char* path = "history_completer.hist";
+
+    // Anel: cheio, a entrada nova substitui a mais antiga
+    History* h = history_create(3);
+    history_add(h, "a");
+    history_add(h, "b");
+    history_add(h, "");     // Vazia: ignorada
+    history_add(h, "b");    // Repete a última: ignorada
+    HISTORICO(h, "a", "b");
+    history_add(h, "c");
+    history_add(h, "d");
+    history_add(h, "e");
+    HISTORICO(h, "c", "d", "e");
+    history_destroy(h);
+
+    // Carga: CRLF, última linha sem '\n' e arquivo maior que o limite (reescrito)
+    FILE* f = fopen(path, "wb");
+    CONFERE(f != NULL);
+    if (!f) return 1;
+    fputs("um\r\ndois\nmais\ntres\r\nquatro", f);
+    fclose(f);
+    h = history_create(3);
+    CONFERE(history_load(h, path) == 0);
+    HISTORICO(h, "mais", "tres", "quatro");
+    history_add(h, "cinco");
+    HISTORICO(h, "tres", "quatro", "cinco");
+    history_destroy(h);
+    h = history_create(10);
+    CONFERE(history_load(h, path) == 0);
+    HISTORICO(h, "mais", "tres", "quatro", "cinco");
+    history_destroy(h);
+    remove(path);
+
+    // Índice de completação: ordenado, sem duplicatas, busca por prefixo
+    Completer* c = completer_create();
+    const char* itens[] = { "config", "commit", "checkout", "clone", "commit", "cherry-pick", "add" };
+    for (size_t i = 0; i < sizeof(itens) / sizeof(itens[0]); i++) CONFERE(completer_add(c, itens[i]) == 0);
+    size_t first = 0;
+    CONFERE(completer_find(c, "ch", 2, &first) == 2);
+    CONFERE(strcmp(completer_get(c, first), "checkout") == 0);
+    CONFERE(strcmp(completer_get(c, first + 1), "cherry-pick") == 0);
+    CONFERE(completer_find(c, "co", 2, &first) == 2);   // "commit" duplicado conta uma vez
+    CONFERE(strcmp(completer_get(c, first), "commit") == 0);
+    CONFERE(completer_find(c, "c", 1, &first) == 5);
+    CONFERE(completer_find(c, "z", 1, &first) == 0);
+    CONFERE(completer_find(c, "", 0, &first) == 6 && first == 0);
+    CONFERE(completer_add(c, "zap") == 0);              // Adição após a busca reordena
+    CONFERE(completer_find(c, "z", 1, &first) == 1 && strcmp(completer_get(c, first), "zap") == 0);
+
+    // Prompt com histórico e completação
+    if (pipe(fds) != 0) return 1;
+    in = inputs_create_fd(fds[0]);
+    r = renderer_create_fd(open("/dev/null", O_WRONLY), 1024);
+    CONFERE(in && r);
+    if (!in || !r) return 1;
+    PromptConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.width = 30;
+
+    historico_base(&cfg);
+    LINHA(&cfg, CIMA "\r", "git status");
+    historico_base(&cfg);
+    LINHA(&cfg, CIMA CIMA CIMA CIMA "\r", "ls");
+    historico_base(&cfg);
+    LINHA(&cfg, "rascunho" CIMA CIMA BAIXO BAIXO "\r", "rascunho");
+    historico_base(&cfg);
+    LINHA(&cfg, CTRL_R "ma\r", "make test");
+    historico_base(&cfg);
+    LINHA(&cfg, CTRL_R "s" CTRL_R CTRL_R "\r", "ls");     // git status -> make test -> ls
+    historico_base(&cfg);
+    LINHA(&cfg, "x" CTRL_R "zz\007\r", "x");              // Sem resultado e Ctrl+G: linha intacta
+    h = historico_base(&cfg);
+    LINHA(&cfg, "pwd\r", "pwd");                          // Enter acrescenta ao histórico
+    HISTORICO(h, "ls", "make test", "git status", "pwd");
+    history_destroy(cfg.history);
+    cfg.history = NULL;
+
+    cfg.complete = completer_prompt_hook;
+    cfg.complete_user = c;
+    LINHA(&cfg, "git che\t\r", "git che");              // checkout/cherry-pick: só o comum ("che")
+    LINHA(&cfg, "git chec\t\r", "git checkout");
+    LINHA(&cfg, "git com" DIR "\r", "git commit");      // Seta direita aceita a sugestão
+    LINHA(&cfg, "git cl\t\r", "git clone");
+    LINHA(&cfg, "git xy\t\r", "git xy");
+
+    completer_destroy(c);
+    inputs_destroy(in);
+    renderer_destroy(r);
+    close(fds[0]);
+    close(fds[1]);
+
+    if (falhas == 0) puts("history_completer: ok");
+    return falhas == 0 ? 0 : 1;
+}
+#endif
@@ -0,0 +1,162 @@
+// Decodificação da entrada: CSI/SS3 com modificadores, UTF-8 (sem colidir com
+// KEY_EXT), sequências e colagens divididas entre leituras e o teto de colagem.
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "C_biblioteca.h"
+
+#ifdef _WIN32
+int main(void) {
+    puts("input_decode: usa pipes POSIX");
+    return 0;
+}
+#else
+#include <unistd.h>
+#include <sys/wait.h>
+
+static int falhas = 0;
+
+#define CONFERE(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); falhas++; } \
+} while (0)
+
+static int fds[2];
+
+// Escreve 'dados' no pipe e os traz para o buffer de 'in'
+static void envia(Inputs* in, const char* dados) {
+    size_t n = strlen(dados);
+    if (write(fds[1], dados, n) != (ssize_t)n) exit(1);
+    while (n > 0) {
+        int lidos = inputs_read(in);
+        if (lidos <= 0) break;
+        n -= (size_t)lidos;
+    }
+}
+
+// Confere que 'seq' vira exatamente uma tecla 'key' com 'mods'
+static void confere_tecla(Inputs* in, const char* seq, int key, int mods, int linha) {
+    InputEvent ev;
+    envia(in, seq);
+    bool ok = inputs_decode(in, &ev, false);
+    if (!ok || ev.type != EV_KEY || ev.key != key || ev.mods != mods || in->len != 0) {
+        fprintf(stderr, "%s:%d: '%s' -> tipo %d tecla 0x%x mods %d (esperado 0x%x/%d)\n",
+                __FILE__, linha, seq + (seq[0] == '\033'), ok ? ev.type : -1, ok ? ev.key : 0,
+                ok ? ev.mods : 0, key, mods);
+        falhas++;
+        in->len = 0;
+    }
+}
+
+#define TECLA(seq, key, mods) confere_tecla(in, seq, key, mods, __LINE__)
+
+int main(void) {
+    if (pipe(fds) != 0) return 1;
+    Inputs* in = inputs_create_fd(fds[0]);
+    CONFERE(in != NULL);
+    if (!in) return 1;
+    InputEvent ev;
+
+    // CSI e SS3, com e sem modificadores xterm
+    TECLA("\033[A", KEY_EXT(KEY_UP), 0);
+    TECLA("\033[1;5C", KEY_EXT(KEY_RIGHT), MOD_CTRL);
+    TECLA("\033[1;3D", KEY_EXT(KEY_LEFT), MOD_ALT);
+    TECLA("\033[H", KEY_EXT(KEY_HOME), 0);
+    TECLA("\033[4~", KEY_EXT(KEY_END), 0);
+    TECLA("\033[3;2~", KEY_EXT(KEY_DELETE), MOD_SHIFT);
+    TECLA("\033[15~", KEY_EXT(KEY_F1 + 4), 0);
+    TECLA("\033[24;6~", KEY_EXT(KEY_F12), MOD_SHIFT | MOD_CTRL);
+    TECLA("\033OA", KEY_EXT(KEY_UP), 0);
+    TECLA("\033OP", KEY_EXT(KEY_F1), 0);
+    TECLA("\033[Z", '\t', MOD_SHIFT);
+
+    // Alt+tecla, controles e teclas simples
+    TECLA("\033x", 'x', MOD_ALT);
+    TECLA("\001", 1, MOD_CTRL);
+    TECLA("\t", '\t', 0);
+    TECLA("\r", KEY_ENTER, 0);
+    TECLA("\177", KEY_BACKSPACE, 0);
+    TECLA("a", 'a', 0);
+
+    // UTF-8: nenhum ponto de código pode cair no range das teclas especiais
+    TECLA("\xd0\xb0", 0x430, 0);            // а (cirílico) != KEY_EXT(KEY_UP)
+    TECLA("\xce\xbb", 0x3BB, 0);            // λ
+    TECLA("\xe2\x82\xac", 0x20AC, 0);       // €
+    TECLA("\xe4\xb8\xad", 0x4E2D, 0);       // 中
+    TECLA("\xf0\x9f\x98\x80", 0x1F600, 0);  // 😀
+    TECLA("\xf4\x8f\xbf\xbf", 0x10FFFF, 0);
+    TECLA("\xf7\xbf\xbf\xbf", 0xFFFD, 0);   // Acima de U+10FFFF
+    CONFERE(!KEY_IS_EXT(0x10FFFF));
+    CONFERE(KEY_IS_EXT(KEY_EXT(KEY_UP)) && KEY_EXT(KEY_UP) != 0x430);
+
+    // Caractere e sequência divididos entre leituras
+    envia(in, "\xe2\x82");
+    CONFERE(!inputs_decode(in, &ev, false));
+    envia(in, "\xac");
+    CONFERE(inputs_decode(in, &ev, false) && ev.type == EV_KEY && ev.key == 0x20AC);
+    envia(in, "\033[1;");
+    CONFERE(!inputs_decode(in, &ev, false));
+    envia(in, "5A");
+    CONFERE(inputs_decode(in, &ev, false) && ev.key == KEY_EXT(KEY_UP) && ev.mods == MOD_CTRL);
+
+    // ESC isolado só sai com 'flush' (tempo de espera esgotado)
+    envia(in, "\033");
+    CONFERE(!inputs_decode(in, &ev, false));
+    CONFERE(inputs_decode(in, &ev, true) && ev.type == EV_KEY && ev.key == KEY_ESC);
+
+    // Colagem dividida entre leituras, inclusive no marcador de fim
+    envia(in, "\033[200~ab\033[A\xd0");
+    CONFERE(!inputs_decode(in, &ev, false));
+    envia(in, "\xb0\033[20");
+    CONFERE(!inputs_decode(in, &ev, false));
+    envia(in, "1~c");
+    CONFERE(inputs_decode(in, &ev, false) && ev.type == EV_PASTE);
+    CONFERE(ev.paste_len == 7 && memcmp(ev.paste, "ab\033[A\xd0\xb0", 7) == 0);
+    CONFERE(inputs_decode(in, &ev, false) && ev.type == EV_KEY && ev.key == 'c');
+
+    // Colagem acima do teto chega em partes, sem perder nem reordenar bytes
+    inputs_destroy(in);
+    close(fds[0]);
+    close(fds[1]);
+    if (pipe(fds) != 0) return 1;
+    in = inputs_create_fd(fds[0]);
+    const size_t total = 2 * INPUTS_PASTE_MAX + 123;
+    pid_t filho = fork();
+    if (filho == 0) {
+        close(fds[0]);
+        char bloco[4096];
+        size_t enviados = 0;
+        if (write(fds[1], "\033[200~", 6) != 6) _exit(1);
+        while (enviados < total) {
+            size_t k = total - enviados < sizeof(bloco) ? total - enviados : sizeof(bloco);
+            for (size_t i = 0; i < k; i++) bloco[i] = (char)('a' + (enviados + i) % 26);
+            if (write(fds[1], bloco, k) != (ssize_t)k) _exit(1);
+            enviados += k;
+        }
+        if (write(fds[1], "\033[201~z", 7) != 7) _exit(1);
+        _exit(0);
+    }
+    close(fds[1]);
+    size_t recebidos = 0;
+    int partes = 0;
+    bool ordem = true;
+    while (inputs_next_event(in, &ev, 2000) == 1 && ev.type == EV_PASTE) {
+        CONFERE(ev.paste_len <= INPUTS_PASTE_MAX);
+        for (size_t i = 0; i < ev.paste_len && ordem; i++) {
+            ordem = ev.paste[i] == (char)('a' + (recebidos + i) % 26);
+        }
+        recebidos += ev.paste_len;
+        partes++;
+    }
+    CONFERE(ordem);
+    CONFERE(recebidos == total);
+    CONFERE(partes == 3);
+    CONFERE(ev.type == EV_KEY && ev.key == 'z');
+    CONFERE(!in->error);
+    waitpid(filho, NULL, 0);
+    inputs_destroy(in);
+    close(fds[0]);
+
+    if (falhas == 0) puts("input_decode: ok");
+    return falhas == 0 ? 0 : 1;
+}
+#endif
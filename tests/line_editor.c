@@ -0,0 +1,109 @@
+// Editor de linha (buffer com lacuna) dirigido por teclas: inserção e remoção no
+// meio, movimento por caractere/palavra, UTF-8, colagem e limite de caracteres.
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "C_biblioteca.h"
+
+#if defined(_WIN32) || defined(TUI_NO_PROMPT)
+int main(void) {
+    puts("line_editor: prompt desligado (TUI_NO_PROMPT) ou sem pipes POSIX");
+    return 0;
+}
+#else
+#include <fcntl.h>
+#include <unistd.h>
+
+static int falhas = 0;
+
+#define CONFERE(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); falhas++; } \
+} while (0)
+
+#define ESQ  "\033[D"
+#define DIR  "\033[C"
+#define INI  "\033[H"
+#define FIM  "\033[F"
+#define DEL  "\033[3~"
+
+static int fds[2];
+static Inputs* in;
+static Renderer* r;
+
+// Digita 'teclas' no prompt e confere a linha devolvida
+static void confere_linha(const PromptConfig* cfg, const char* teclas, const char* esperado, int linha) {
+    size_t n = strlen(teclas);
+    if (write(fds[1], teclas, n) != (ssize_t)n) exit(1);
+    char* obtido = inputs_prompt_cfg(in, r, 1, 1, cfg);
+    if (!obtido || strcmp(obtido, esperado) != 0) {
+        fprintf(stderr, "%s:%d: obtido '%s', esperado '%s'\n", __FILE__, linha, obtido ? obtido : "(null)", esperado);
+        falhas++;
+    }
+    if (in->len != 0) {
+        fprintf(stderr, "%s:%d: sobraram %zu bytes na entrada\n", __FILE__, linha, in->len);
+        falhas++;
+        in->len = 0;
+    }
+    free(obtido);
+}
+
+#define LINHA(cfg, teclas, esperado) confere_linha(cfg, teclas, esperado, __LINE__)
+
+int main(void) {
+    if (pipe(fds) != 0) return 1;
+    in = inputs_create_fd(fds[0]);
+    r = renderer_create_fd(open("/dev/null", O_WRONLY), 1024);
+    CONFERE(in && r);
+    if (!in || !r) return 1;
+
+    PromptConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.width = 20;
+
+    // Edição no meio da linha (a lacuna acompanha o cursor)
+    LINHA(&cfg, "abc" ESQ ESQ "X" FIM "\b\r", "aXb");
+    LINHA(&cfg, "abc" ESQ ESQ DEL "\r", "ac");
+    LINHA(&cfg, "abc" INI DEL "\r", "bc");
+    LINHA(&cfg, "abc" INI "\b" DIR "Y\r", "aYbc");
+    LINHA(&cfg, "foo bar" INI "\013baz\r", "baz");         // Ctrl+K
+    LINHA(&cfg, "foo bar" ESQ "\025\r", "r");              // Ctrl+U
+    LINHA(&cfg, "hello world\027\r", "hello ");           // Ctrl+W
+    LINHA(&cfg, "um dois" "\033b" "X\r", "um Xdois");      // Alt+b
+    LINHA(&cfg, "um dois" INI "\033f" "X\r", "umX dois");  // Alt+f
+    LINHA(&cfg, "um dois tres" "\033[1;5D" "\033[1;5D" "\033\177" "\r", "dois tres"); // Ctrl+seta, Alt+Backspace
+
+    // UTF-8: cursor e remoção andam por caractere, inclusive acima de U+03E8
+    LINHA(&cfg, "ção" ESQ "\b\r", "ço");
+    LINHA(&cfg, "привет" ESQ ESQ "\b\r", "приет");
+    LINHA(&cfg, "中文😀" ESQ "x\r", "中文x😀");
+
+    // Colagem entra de uma vez; controles viram espaço (CRLF conta como um) e
+    // sequências coladas não são interpretadas como teclas
+    LINHA(&cfg, "a\033[200~x\r\ny\033[A\033[201~b\r", "ax y [Ab");
+
+    // Texto maior que o campo rola sem perder caracteres; limite de caracteres
+    char longo[128];
+    for (int i = 0; i < 100; i++) longo[i] = (char)('a' + i % 26);
+    longo[100] = '\0';
+    char teclas[160];
+    snprintf(teclas, sizeof(teclas), "%s\r", longo);
+    LINHA(&cfg, teclas, longo);
+    cfg.max_chars = 3;
+    LINHA(&cfg, "abcdef\r", "abc");
+    LINHA(&cfg, "ab\033[200~xyz\033[201~\r", "abx");
+    cfg.max_chars = 0;
+
+    // Texto inicial
+    cfg.initial = "pre";
+    LINHA(&cfg, "fixo\r", "prefixo");
+    cfg.initial = NULL;
+
+    inputs_destroy(in);
+    renderer_destroy(r);
+    close(fds[0]);
+    close(fds[1]);
+
+    if (falhas == 0) puts("line_editor: ok");
+    return falhas == 0 ? 0 : 1;
+}
+#endif
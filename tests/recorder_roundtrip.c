@@ -0,0 +1,62 @@
+// Grava eventos de entrada e confere que a reprodução devolve exatamente os mesmos,
+// incluindo a tecla 0 (Ctrl+@), que não pode virar colagem.
+#include <stdio.h>
+#include <string.h>
+#include "C_biblioteca.h"
+
+#ifdef TUI_NO_RECORDER
+int main(void) {
+    puts("recorder_roundtrip: gravação desligada (TUI_NO_RECORDER)");
+    return 0;
+}
+#else
+static int falhas = 0;
+
+#define CONFERE(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); falhas++; } \
+} while (0)
+
+int main(void) {
+    const char* path = "recorder_roundtrip.rec";
+    InputEvent enviados[5];
+    memset(enviados, 0, sizeof(enviados));
+    enviados[0].type = EV_KEY;    enviados[0].key = 0;   enviados[0].mods = MOD_CTRL;
+    enviados[1].type = EV_PASTE;  enviados[1].paste = "colado\n"; enviados[1].paste_len = 7;
+    enviados[2].type = EV_KEY;    enviados[2].key = 'a';
+    enviados[3].type = EV_PASTE;  enviados[3].paste = "";  enviados[3].paste_len = 0;
+    enviados[4].type = EV_RESIZE; enviados[4].rows = 40; enviados[4].cols = 120;
+
+    Recorder* rec = recorder_create(path);
+    CONFERE(rec != NULL);
+    if (!rec) return 1;
+    for (int i = 0; i < 5; i++) recorder_input(rec, &enviados[i]);
+    recorder_destroy(rec);
+
+    Replayer* rp = replayer_open(path);
+    CONFERE(rp != NULL);
+    if (!rp) return 1;
+    ReplayRecord r;
+    int lidos = 0;
+    while (replayer_next(rp, &r) == 1) {
+        CONFERE(lidos < 5);
+        if (lidos >= 5) break;
+        const InputEvent* e = &enviados[lidos++];
+        CONFERE(r.ev.type == e->type);
+        if (e->type == EV_KEY) {
+            CONFERE(r.ev.key == e->key);
+            CONFERE(r.ev.mods == e->mods);
+        } else if (e->type == EV_PASTE) {
+            CONFERE(r.ev.paste_len == e->paste_len);
+            CONFERE(memcmp(r.ev.paste, e->paste, e->paste_len) == 0);
+        } else {
+            CONFERE(r.ev.rows == e->rows && r.ev.cols == e->cols);
+        }
+    }
+    CONFERE(lidos == 5);
+    replayer_close(rp);
+    remove(path);
+
+    if (falhas == 0) puts("recorder_roundtrip: ok");
+    return falhas == 0 ? 0 : 1;
+}
+#endif
@@ -0,0 +1,182 @@
+// Saída do renderer: trechos por referência intercalados com cópias (faixas
+// contíguas do buffer viram um único trecho), escrita parcial em saída
+// não-bloqueante, despejo automático no teto e atualização sincronizada.
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "C_biblioteca.h"
+
+#ifdef _WIN32
+int main(void) {
+    puts("renderer_output: usa pipes POSIX");
+    return 0;
+}
+#else
+#include <fcntl.h>
+#include <unistd.h>
+
+static int falhas = 0;
+
+#define CONFERE(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); falhas++; } \
+} while (0)
+
+// Saída capturada por um pipe não-bloqueante
+typedef struct {
+    int fds[2];
+    char* dados;
+    size_t len, cap;
+} Captura;
+
+static void captura_abre(Captura* c) {
+    memset(c, 0, sizeof(*c));
+    if (pipe(c->fds) != 0) exit(1);
+    fcntl(c->fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(c->fds[1], F_SETFL, O_NONBLOCK);
+}
+
+// Lê tudo o que está no pipe agora
+static void captura_le(Captura* c) {
+    while (true) {
+        if (c->len + 4096 > c->cap) {
+            c->cap = c->cap ? c->cap * 2 : 65536;
+            c->dados = (char*)realloc(c->dados, c->cap);
+            if (!c->dados) exit(1);
+        }
+        ssize_t n = read(c->fds[0], c->dados + c->len, c->cap - c->len);
+        if (n <= 0) break;
+        c->len += (size_t)n;
+    }
+}
+
+static void captura_fecha(Captura* c) {
+    close(c->fds[0]);
+    close(c->fds[1]);
+    free(c->dados);
+}
+
+// Despeja o renderer até o fim, esvaziando o pipe entre as tentativas
+static void despeja(Renderer* r, Captura* c) {
+    for (int i = 0; i < 10000 && renderer_pending(r); i++) {
+        captura_le(c);
+        if (renderer_render(r) < 0) break;
+    }
+    captura_le(c);
+}
+
+// Conta as ocorrências de 'agulha' na saída capturada
+static int conta(const Captura* c, const char* agulha) {
+    size_t n = strlen(agulha);
+    int total = 0;
+    for (size_t i = 0; i + n <= c->len; i++) {
+        if (memcmp(c->dados + i, agulha, n) == 0) total++;
+    }
+    return total;
+}
+
+int main(void) {
+    Captura c;
+
+    // Referências e cópias na ordem em que foram adicionadas; cópias seguidas
+    // formam uma única faixa do buffer
+    captura_abre(&c);
+    Renderer* r = renderer_create_fd(c.fds[1], 256);
+    CONFERE(r != NULL);
+    if (!r) return 1;
+    renderer_set_zero_copy(r, true, 16);
+    static const char grande1[] = "0123456789abcdefghijklmnopqrstuv";
+    static const char grande2[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ-+*/=!";
+    renderer_add(r, "um ");
+    renderer_add_ref(r, grande1);
+    renderer_add(r, "dois ");
+    renderer_add(r, "tres ");
+    renderer_add_ref(r, "curto");           // Abaixo do mínimo: copiado na mesma faixa
+    renderer_add_ref(r, grande2);
+    CONFERE(r->seg_count == 4);             // faixa, ref, faixa, ref
+    CONFERE(r->segs[1].ref == grande1 && r->segs[3].ref == grande2);
+    renderer_add(r, " fim");
+    CONFERE(renderer_render(r) == 0);
+    CONFERE(!renderer_pending(r));
+    captura_le(&c);
+    const char* esperado = "um 0123456789abcdefghijklmnopqrstuvdois tres curtoABCDEFGHIJKLMNOPQRSTUVWXYZ-+*/=! fim";
+    CONFERE(c.len == strlen(esperado) && memcmp(c.dados, esperado, c.len) == 0);
+    renderer_destroy(r);
+    captura_fecha(&c);
+
+    // Escrita parcial: o render para com a saída cheia (1) e o restante, inclusive
+    // o que era referência, fica guardado para o próximo render
+    captura_abre(&c);
+    r = renderer_create_fd(c.fds[1], 4096);
+    renderer_set_zero_copy(r, true, 16);
+    const size_t tam = 256 * 1024;
+    char* ref = (char*)malloc(tam);
+    char* esperado2 = (char*)malloc(tam + 64);
+    if (!ref || !esperado2) return 1;
+    for (size_t i = 0; i < tam; i++) ref[i] = (char)('a' + i % 26);
+    renderer_add(r, "[inicio]");
+    renderer_add_ref_raw(r, ref, tam);
+    renderer_add(r, "[fim]");
+    memcpy(esperado2, "[inicio]", 8);
+    memcpy(esperado2 + 8, ref, tam);
+    memcpy(esperado2 + 8 + tam, "[fim]", 5);
+    CONFERE(renderer_render(r) == 1);
+    CONFERE(renderer_pending(r) && r->blocked);
+    memset(ref, '#', tam);                  // Referência já pode ser reutilizada
+    despeja(r, &c);
+    CONFERE(!renderer_pending(r));
+    CONFERE(c.len == tam + 13 && memcmp(c.dados, esperado2, c.len) == 0);
+    renderer_destroy(r);
+    captura_fecha(&c);
+
+    // Teto com despejo automático: pedaço maior que o buffer inteiro vai direto
+    // para a saída, e a parte que não coube no pipe não se perde
+    captura_abre(&c);
+    r = renderer_create_fd(c.fds[1], 256);
+    renderer_set_limits(r, 1024, true);
+    for (size_t i = 0; i < tam; i++) ref[i] = (char)('A' + i % 26);
+    CONFERE(renderer_add(r, "<") == 0);
+    CONFERE(renderer_add_raw(r, ref, tam) == 0);
+    CONFERE(renderer_add(r, ">") == 0);
+    CONFERE(renderer_pending(r));
+    despeja(r, &c);
+    CONFERE(c.len == tam + 2 && c.dados[0] == '<' && c.dados[c.len - 1] == '>');
+    CONFERE(c.len == tam + 2 && memcmp(c.dados + 1, ref, tam) == 0);
+    renderer_destroy(r);
+    captura_fecha(&c);
+
+    // Teto sem despejo automático: a adição é recusada e o erro fica registrado
+    captura_abre(&c);
+    r = renderer_create_fd(c.fds[1], 256);
+    renderer_set_limits(r, 1024, false);
+    CONFERE(renderer_add_raw(r, ref, 2000) == -1);
+    CONFERE(renderer_error(r));
+    renderer_discard(r);
+    CONFERE(renderer_add(r, "ok") == 0 && !renderer_error(r));
+    CONFERE(renderer_render(r) == 0);
+    captura_le(&c);
+    CONFERE(c.len == 2 && memcmp(c.dados, "ok", 2) == 0);
+    renderer_destroy(r);
+    captura_fecha(&c);
+
+    // Atualização sincronizada: um despejo automático no meio do quadro não fecha
+    // o modo 2026 antes do render
+    captura_abre(&c);
+    r = renderer_create_fd(c.fds[1], 256);
+    TermCaps caps = { CAP_COLOR_16, true, false, true };
+    renderer_set_caps(r, &caps);
+    renderer_set_limits(r, 1024, true);
+    for (int i = 0; i < 50; i++) renderer_add(r, "linha de texto que enche o buffer\n");
+    CONFERE(renderer_render(r) == 0);
+    captura_le(&c);
+    CONFERE(conta(&c, "\033[?2026h") == 1 && conta(&c, "\033[?2026l") == 1);
+    CONFERE(c.len > 16 && memcmp(c.dados, "\033[?2026h", 8) == 0);
+    CONFERE(c.len > 16 && memcmp(c.dados + c.len - 8, "\033[?2026l", 8) == 0);
+    renderer_destroy(r);
+    captura_fecha(&c);
+
+    free(ref);
+    free(esperado2);
+    if (falhas == 0) puts("renderer_output: ok");
+    return falhas == 0 ? 0 : 1;
+}
+#endif
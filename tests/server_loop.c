@@ -0,0 +1,110 @@
+// Laço de sessões: cada cliente recebe só a própria saída, um cliente que sai
+// antes da resposta encerra apenas a sua sessão (sem SIGPIPE), e server_run
+// termina quando não restam sessões.
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "C_biblioteca.h"
+
+#if defined(_WIN32) || defined(TUI_NO_SERVER)
+int main(void) {
+    puts("server_loop: servidor desligado (TUI_NO_SERVER) ou fora do POSIX");
+    return 0;
+}
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+static int falhas = 0;
+
+#define CONFERE(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); falhas++; } \
+} while (0)
+
+static int fechadas = 0;
+
+// Ecoa cada tecla em maiúscula ('?' fora do ASCII); 'q' encerra a sessão
+static void ao_receber(Server* srv, Session* s, void* user) {
+    (void)user;
+    InputEvent ev;
+    while (inputs_decode(s->in, &ev, false)) {
+        if (ev.type != EV_KEY) continue;
+        if (ev.key == 'q') {
+            server_close(srv, s);
+            return;
+        }
+        char c = ev.key >= 'a' && ev.key <= 'z' ? (char)(ev.key - 32) : ev.key < 128 ? (char)ev.key : '?';
+        renderer_add_raw(s->r, &c, 1);
+    }
+}
+
+static void ao_fechar(Server* srv, Session* s, void* user) {
+    (void)srv;
+    (void)user;
+    fechadas++;
+    *(int*)s->user = -1;
+}
+
+// Lê o que o cliente recebeu (o socket do cliente é não-bloqueante)
+static size_t recebe(int fd, char* buf, size_t n) {
+    size_t total = 0;
+    ssize_t k;
+    while (total + 1 < n && (k = read(fd, buf + total, n - 1 - total)) > 0) total += (size_t)k;
+    buf[total] = '\0';
+    return total;
+}
+
+int main(void) {
+    Server* srv = server_create(ao_receber, ao_fechar, NULL);
+    CONFERE(srv != NULL);
+    if (!srv) return 1;
+
+    int par[3][2];
+    int estado[3] = { 0, 0, 0 };
+    for (int i = 0; i < 3; i++) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, par[i]) != 0) return 1;
+        fcntl(par[i][1], F_SETFL, O_NONBLOCK);
+        CONFERE(server_add(srv, par[i][0], par[i][0], true, &estado[i]) != NULL);
+    }
+    char buf[64];
+
+    // Cada sessão recebe só o eco da própria entrada
+    CONFERE(write(par[0][1], "abc", 3) == 3);
+    CONFERE(write(par[1][1], "xy", 2) == 2);
+    CONFERE(server_poll(srv, 100) == 3);
+    CONFERE(recebe(par[0][1], buf, sizeof(buf)) == 3 && strcmp(buf, "ABC") == 0);
+    CONFERE(recebe(par[1][1], buf, sizeof(buf)) == 2 && strcmp(buf, "XY") == 0);
+    CONFERE(recebe(par[2][1], buf, sizeof(buf)) == 0);
+
+    // Caractere dividido entre leituras vira uma única tecla
+    CONFERE(write(par[2][1], "\xd0", 1) == 1);
+    CONFERE(server_poll(srv, 100) == 3);
+    CONFERE(write(par[2][1], "\xb0z", 2) == 2);
+    CONFERE(server_poll(srv, 100) == 3);
+    CONFERE(recebe(par[2][1], buf, sizeof(buf)) == 2 && strcmp(buf, "?Z") == 0);
+
+    // Cliente que sai antes de receber a resposta: EPIPE encerra só a sessão dele
+    CONFERE(write(par[1][1], "zz", 2) == 2);
+    close(par[1][1]);
+    CONFERE(server_poll(srv, 100) == 2);
+    CONFERE(fechadas == 1 && estado[1] == -1);
+    CONFERE(estado[0] == 0 && estado[2] == 0);
+
+    CONFERE(write(par[0][1], "d", 1) == 1);
+    CONFERE(server_poll(srv, 100) == 2);
+    CONFERE(recebe(par[0][1], buf, sizeof(buf)) == 1 && strcmp(buf, "D") == 0);
+
+    // Encerramento pelo callback; server_run volta quando não restam sessões
+    CONFERE(write(par[0][1], "q", 1) == 1);
+    CONFERE(write(par[2][1], "q", 1) == 1);
+    server_run(srv);
+    CONFERE(srv->count == 0 && fechadas == 3);
+    server_destroy(srv);
+    close(par[0][1]);
+    close(par[2][1]);
+
+    if (falhas == 0) puts("server_loop: ok");
+    return falhas == 0 ? 0 : 1;
+}
+#endif
@@ -0,0 +1,187 @@
+// Tabela: a visão ordenada segue uma ordem total (números antes de texto) depois
+// de alterações em lote, e o desenho reenvia só as linhas da janela que mudaram.
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "C_biblioteca.h"
+
+#ifdef TUI_NO_WIDGETS
+int main(void) {
+    puts("table_view: widgets desligados (TUI_NO_WIDGETS)");
+    return 0;
+}
+#else
+static int falhas = 0;
+
+#define CONFERE(cond) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); falhas++; } \
+} while (0)
+
+// Ordem esperada da coluna: números (por valor) antes de texto (strcmp)
+static int compara_celula(const char* a, const char* b) {
+    char* fa;
+    char* fb;
+    double da = strtod(a, &fa), db = strtod(b, &fb);
+    bool na = fa != a && *fa == '\0' && da == da;
+    bool nb = fb != b && *fb == '\0' && db == db;
+    if (na != nb) return na ? -1 : 1;
+    if (na) return (da > db) - (da < db);
+    return strcmp(a, b);
+}
+
+// Confere que a visão é uma permutação das linhas em ordem (desempate pela inserção)
+static void confere_ordem(Table* t, int col, bool desc, int linha) {
+    int n = table_row_count(t);
+    char* visto = (char*)calloc(n > 0 ? n : 1, 1);
+    int anterior = -1;
+    for (int p = 0; p < n; p++) {
+        int row = table_row_at(t, p);
+        if (row < 0 || row >= n || visto[row]) {
+            fprintf(stderr, "%s:%d: posição %d com linha %d inválida ou repetida\n", __FILE__, linha, p, row);
+            falhas++;
+            break;
+        }
+        visto[row] = 1;
+        if (anterior >= 0) {
+            int c = compara_celula(table_get_cell(t, anterior, col), table_get_cell(t, row, col));
+            if (desc) c = -c;
+            if (c > 0 || (c == 0 && anterior > row)) {
+                fprintf(stderr, "%s:%d: '%s' (linha %d) antes de '%s' (linha %d)\n", __FILE__, linha,
+                        table_get_cell(t, anterior, col), anterior, table_get_cell(t, row, col), row);
+                falhas++;
+                break;
+            }
+        }
+        anterior = row;
+    }
+    free(visto);
+}
+
+#define ORDEM(t, col, desc) confere_ordem(t, col, desc, __LINE__)
+
+static unsigned semente = 12345;
+static unsigned aleatorio(void) {
+    semente = semente * 1103515245u + 12345u;
+    return (semente >> 16) & 0x7FFF;
+}
+
+// Valor misturando inteiros, decimais, negativos e texto que começa com dígito
+static void valor(char* buf, size_t n) {
+    switch (aleatorio() % 5) {
+        case 0: snprintf(buf, n, "%u", aleatorio() % 100); break;
+        case 1: snprintf(buf, n, "-%u.%u", aleatorio() % 50, aleatorio() % 10); break;
+        case 2: snprintf(buf, n, "%ua", aleatorio() % 20); break;
+        case 3: snprintf(buf, n, "item%u", aleatorio() % 30); break;
+        default: snprintf(buf, n, "%u", aleatorio() % 1000); break;
+    }
+}
+
+// Texto desenhado desde o último descarte
+static bool desenhou(const Renderer* r, const char* texto) {
+    size_t n = strlen(texto);
+    for (size_t i = 0; i + n <= r->size; i++) {
+        if (memcmp(r->buffer + i, texto, n) == 0) return true;
+    }
+    return false;
+}
+
+int main(void) {
+    // Caso mínimo da ordem não transitiva: "1a" < "9" < "10" < "1a" com strcmp misto
+    Table* t = table_create(1);
+    CONFERE(t != NULL);
+    if (!t) return 1;
+    const char* mistos[] = { "1a", "9", "10", "b", "-3", "1a", "nan", "2.5" };
+    for (int i = 0; i < 8; i++) CONFERE(table_append(t, &mistos[i]) == i);
+    table_sort(t, 0, false);
+    ORDEM(t, 0, false);
+    CONFERE(strcmp(table_get_cell(t, table_row_at(t, 0), 0), "-3") == 0);
+    CONFERE(strcmp(table_get_cell(t, table_row_at(t, 4), 0), "1a") == 0);
+    table_sort(t, 0, true);
+    ORDEM(t, 0, true);
+    table_destroy(t);
+
+    // Alterações na coluna de ordenação são reinseridas em lote na posição certa
+    t = table_create(2);
+    char buf[32], id[16];
+    for (int i = 0; i < 300; i++) {
+        valor(buf, sizeof(buf));
+        snprintf(id, sizeof(id), "r%d", i);
+        const char* cel[] = { buf, id };
+        CONFERE(table_append(t, cel) == i);
+    }
+    table_sort(t, 0, false);
+    ORDEM(t, 0, false);
+    for (int lote = 0; lote < 20; lote++) {
+        int k = 1 + (int)(aleatorio() % 40);
+        for (int j = 0; j < k; j++) {
+            valor(buf, sizeof(buf));
+            CONFERE(table_set_cell(t, (int)(aleatorio() % 300), 0, buf) == 0);
+        }
+        if (lote % 3 == 0) {
+            valor(buf, sizeof(buf));
+            snprintf(id, sizeof(id), "n%d", lote);
+            const char* cel[] = { buf, id };
+            table_append(t, cel);
+        }
+        ORDEM(t, 0, false);
+    }
+    table_sort(t, 0, true);
+    for (int j = 0; j < 50; j++) {
+        valor(buf, sizeof(buf));
+        table_set_cell(t, (int)(aleatorio() % 300), 0, buf);
+    }
+    ORDEM(t, 0, true);
+    table_destroy(t);
+
+    // Redesenho por linha: janela com cabeçalho e 3 linhas
+    Renderer* r = renderer_create_fd(TUI_FD_INVALID, 4096);
+    t = table_create(2);
+    CONFERE(r && t);
+    if (!r || !t) return 1;
+    table_set_column(t, 0, "Nome", 8, 8, TABLE_LEFT);
+    table_set_column(t, 1, "Valor", 6, 6, TABLE_RIGHT);
+    const char* linhas[][2] = { { "ana", "3" }, { "bia", "1" }, { "caio", "2" }, { "davi", "9" }, { "eva", "5" } };
+    for (int i = 0; i < 5; i++) table_append(t, linhas[i]);
+    table_set_view(t, 1, 1, 4, 20);
+
+    table_draw(t, r);
+    CONFERE(desenhou(r, "Nome") && desenhou(r, "ana") && desenhou(r, "caio"));
+    CONFERE(!desenhou(r, "davi"));
+    renderer_discard(r);
+
+    table_draw(t, r);
+    CONFERE(r->size == 0);                  // Nada mudou: nada é reenviado
+
+    table_set_cell(t, 1, 1, "77");          // Linha visível
+    table_set_cell(t, 4, 1, "88");          // Fora da janela
+    table_draw(t, r);
+    CONFERE(desenhou(r, "bia") && desenhou(r, "77"));
+    CONFERE(!desenhou(r, "ana") && !desenhou(r, "caio") && !desenhou(r, "Nome") && !desenhou(r, "88"));
+    renderer_discard(r);
+
+    // Ordenar move linhas: só as posições cuja linha exibida mudou são reenviadas
+    table_sort(t, 1, false);                // caio 2, ana 3, davi 9, bia 77, eva 88
+    table_draw(t, r);
+    CONFERE(desenhou(r, "caio") && desenhou(r, "ana") && desenhou(r, "davi"));
+    CONFERE(!desenhou(r, "bia") && !desenhou(r, "Nome"));
+    renderer_discard(r);
+
+    table_scroll(t, 2, 0);                  // davi, bia, eva
+    table_draw(t, r);
+    CONFERE(desenhou(r, "bia") && desenhou(r, "eva") && desenhou(r, "davi"));
+    renderer_discard(r);
+    table_draw(t, r);
+    CONFERE(r->size == 0);
+
+    table_invalidate(t);
+    table_draw(t, r);
+    CONFERE(desenhou(r, "Nome") && desenhou(r, "davi") && desenhou(r, "eva"));
+    renderer_discard(r);
+
+    table_destroy(t);
+    renderer_destroy(r);
+
+    if (falhas == 0) puts("table_view: ok");
+    return falhas == 0 ? 0 : 1;
+}
+#endif